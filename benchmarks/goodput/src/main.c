@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <hdlc.h>
+#include <hdlc_deframer.h>
+#include <hdlc_retx.h>
+#include <hdlc_rtt.h>
+#include <hdlc_sim.h>
+#include <hdlc_timer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADDRESS 0x03
+
+#define BANDWIDTH     1000000   // Bits per second in both directions
+#define LATENCY       1000000   // One way latency in nanoseconds
+#define TIME_LIMIT    600000000000ULL // Give up on a run after this much simulated time
+#define NS_PER_TICK   1000      // Timer wheel ticks are microseconds
+#define DEFAULT_SEED  0x5EED
+#define DEFAULT_BYTES 65536
+
+#define INITIAL_RTO 100000 // Ticks
+#define MIN_RTO     20000
+#define MAX_RTO     500000
+
+#define SEQUENCE_MASK 0x07
+
+static const double bit_error_rates[] = {0.0, 1e-6, 1e-5, 1e-4, 3e-4, 1e-3};
+static const int windows[] = {1, 2, 4, 7};
+static const int frame_sizes[] = {16, 64, 128, 255};
+
+#define COUNT(array) ((int)(sizeof(array) / sizeof((array)[0])))
+
+typedef struct {
+	hdlc_retx_store_t store;
+	hdlc_rtt_t rtt;
+	hdlc_timer_t t1;
+	hdlc_sim_time_t t1_deadline;
+	int timed_out;
+
+	uint8_t vs; // Next N(S) to send
+	uint8_t va; // Oldest unacknowledged N(S)
+	int outstanding;
+
+	size_t offset; // Next payload byte that has not been sent yet
+
+	uint64_t frames;
+	uint64_t retransmissions;
+	uint64_t timeouts;
+	uint64_t wire_bytes;
+
+	hdlc_deframer_t deframer;
+	hdlc_frame_t rx_frame;
+	hdlc_sim_time_t now;
+} sender_t;
+
+typedef struct {
+	uint8_t vr; // Next N(S) expected
+	size_t delivered;
+	int ack_pending;
+
+	uint64_t corrupted;
+
+	hdlc_deframer_t deframer;
+	hdlc_frame_t rx_frame;
+} receiver_t;
+
+typedef struct {
+	double bit_error_rate;
+	int window;
+	int frame_size;
+} run_config_t;
+
+typedef struct {
+	hdlc_sim_time_t elapsed;
+	size_t delivered;
+	int completed;
+} run_result_t;
+
+// The channels carry a sizeable ring each, keep them off the stack
+static hdlc_sim_channel_t forward_channel;
+static hdlc_sim_channel_t reverse_channel;
+static hdlc_timer_wheel_t wheel;
+static sender_t sender;
+static receiver_t receiver;
+
+static uint8_t *payload;
+static size_t payload_len;
+
+//--------------------------------------------------
+static hdlc_tick_t to_tick(hdlc_sim_time_t now)
+{
+	return (hdlc_tick_t)(now / NS_PER_TICK);
+}
+
+//--------------------------------------------------
+static void t1_expired(void *user, hdlc_timer_t *timer)
+{
+	(void)timer;
+
+	// Retransmit from the main loop rather than from inside the wheel
+	sender_t *s = user;
+	s->timed_out = 1;
+}
+
+//--------------------------------------------------
+static void t1_restart(sender_t *s, hdlc_sim_time_t now)
+{
+	const hdlc_tick_t rto = hdlc_rtt_rto(&s->rtt);
+
+	hdlc_timer_cancel(&wheel, &s->t1);
+	hdlc_timer_start(&wheel, &s->t1, rto);
+
+	s->t1_deadline = ((hdlc_sim_time_t)to_tick(now) + rto) * NS_PER_TICK;
+}
+
+//--------------------------------------------------
+static int sender_fill_window(sender_t *s, const run_config_t *config, hdlc_sim_time_t now)
+{
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+
+	while (s->outstanding < config->window && s->offset < payload_len) {
+		hdlc_frame_t frame;
+		hdlc_frame_init(&frame);
+
+		size_t chunk = payload_len - s->offset;
+		if (chunk > (size_t)config->frame_size) {
+			chunk = (size_t)config->frame_size;
+		}
+
+		frame.address = ADDRESS;
+		hdlc_i_frame_control_init(&frame.control, s->vs, 0, 0);
+		memcpy(frame.info, payload + s->offset, chunk);
+		frame.info_len = (hdlc_info_len_t)chunk;
+
+		if (hdlc_retx_store_put(&s->store, &frame) < 0) {
+			return -1;
+		}
+
+		const int len = hdlc_retx_store_get(&s->store, s->vs, NULL, buffer, sizeof(buffer));
+		if (len < 0 || hdlc_sim_channel_write(&forward_channel, now, buffer, len) != len) {
+			return -1;
+		}
+
+		hdlc_rtt_on_send(&s->rtt, s->vs, to_tick(now));
+
+		if (!hdlc_timer_active(&s->t1)) {
+			t1_restart(s, now);
+		}
+
+		s->vs = (s->vs + 1) & SEQUENCE_MASK;
+		s->offset += chunk;
+		s->outstanding++;
+		s->frames++;
+		s->wire_bytes += (uint64_t)len;
+	}
+
+	return 0;
+}
+
+// Go back N: resend everything that is still outstanding, polling with the first frame
+//--------------------------------------------------
+static int sender_retransmit(sender_t *s, hdlc_sim_time_t now)
+{
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+
+	s->timed_out = 0;
+	s->timeouts++;
+
+	hdlc_rtt_on_timeout(&s->rtt);
+
+	for (int i = 0; i < s->outstanding; i++) {
+		const uint8_t ns = (s->va + i) & SEQUENCE_MASK;
+
+		hdlc_control_t control;
+		hdlc_i_frame_control_init(&control, ns, i == 0, 0);
+
+		const int len = hdlc_retx_store_get(&s->store, ns, &control, buffer, sizeof(buffer));
+		if (len < 0 || hdlc_sim_channel_write(&forward_channel, now, buffer, len) != len) {
+			return -1;
+		}
+
+		hdlc_rtt_on_send(&s->rtt, ns, to_tick(now));
+
+		s->retransmissions++;
+		s->wire_bytes += (uint64_t)len;
+	}
+
+	if (s->outstanding > 0) {
+		t1_restart(s, now);
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+static void sender_on_ack(sender_t *s, uint8_t nr, hdlc_sim_time_t now)
+{
+	const int acked = (nr - s->va) & SEQUENCE_MASK;
+
+	// Stale or duplicate acknowledgement
+	if (acked == 0 || acked > s->outstanding) {
+		return;
+	}
+
+	for (int i = 0; i < acked; i++) {
+		hdlc_retx_store_release(&s->store, s->va);
+		s->va = (s->va + 1) & SEQUENCE_MASK;
+	}
+
+	s->outstanding -= acked;
+
+	hdlc_rtt_on_ack(&s->rtt, nr, to_tick(now));
+
+	if (s->outstanding > 0) {
+		t1_restart(s, now);
+	} else {
+		hdlc_timer_cancel(&wheel, &s->t1);
+		s->timed_out = 0;
+	}
+}
+
+//--------------------------------------------------
+static void receiver_on_frame(void *user, const hdlc_frame_desc_t *desc)
+{
+	receiver_t *r = user;
+	const hdlc_frame_t *frame = desc->frame;
+
+	// Only I-frames travel in this direction
+	if (frame->address != ADDRESS) {
+		return;
+	}
+
+	// Anything out of sequence is dropped and answered with the current N(R)
+	r->ack_pending = 1;
+
+	if (frame->control.i_fields.ns != r->vr) {
+		return;
+	}
+
+	if (r->delivered + frame->info_len > payload_len ||
+	    memcmp(payload + r->delivered, frame->info, frame->info_len) != 0) {
+		r->corrupted++;
+		return;
+	}
+
+	r->delivered += frame->info_len;
+	r->vr = (r->vr + 1) & SEQUENCE_MASK;
+}
+
+//--------------------------------------------------
+static int receiver_send_ack(receiver_t *r, hdlc_sim_time_t now)
+{
+	uint8_t buffer[16];
+
+	hdlc_frame_t frame;
+	hdlc_frame_init(&frame);
+
+	frame.address = ADDRESS;
+	hdlc_s_frame_control_init(&frame.control, HDLC_CONTROL_S_FRAME_CODE_RR, 0, r->vr);
+
+	const int len = hdlc_encode(&frame, buffer, sizeof(buffer));
+	if (len < 0 || hdlc_sim_channel_write(&reverse_channel, now, buffer, len) != len) {
+		return -1;
+	}
+
+	r->ack_pending = 0;
+
+	return 0;
+}
+
+//--------------------------------------------------
+static void sender_on_frame(void *user, const hdlc_frame_desc_t *desc)
+{
+	sender_t *s = user;
+	const hdlc_frame_t *frame = desc->frame;
+
+	// Only RR is ever sent back
+	if (frame->address == ADDRESS && frame->control.s_fields.s == HDLC_CONTROL_S_FRAME_CODE_RR) {
+		sender_on_ack(s, frame->control.s_fields.nr, s->now);
+	}
+}
+
+//--------------------------------------------------
+static void process_forward(hdlc_sim_time_t now)
+{
+	uint8_t buffer[1024];
+
+	int len;
+	while ((len = hdlc_sim_channel_read(&forward_channel, now, buffer, sizeof(buffer))) > 0) {
+		hdlc_deframer_push(&receiver.deframer, buffer, len);
+	}
+}
+
+//--------------------------------------------------
+static void process_reverse(hdlc_sim_time_t now)
+{
+	uint8_t buffer[256];
+
+	sender.now = now;
+
+	int len;
+	while ((len = hdlc_sim_channel_read(&reverse_channel, now, buffer, sizeof(buffer))) > 0) {
+		hdlc_deframer_push(&sender.deframer, buffer, len);
+	}
+}
+
+// Earliest point in time at which something can happen, 0 when the link has stalled
+//--------------------------------------------------
+static hdlc_sim_time_t next_event(void)
+{
+	hdlc_sim_time_t next = 0;
+	hdlc_sim_time_t time;
+
+	if (hdlc_sim_channel_next_delivery(&forward_channel, &time) == 0) {
+		next = time;
+	}
+
+	if (hdlc_sim_channel_next_delivery(&reverse_channel, &time) == 0 &&
+	    (next == 0 || time < next)) {
+		next = time;
+	}
+
+	if (hdlc_timer_active(&sender.t1) && (next == 0 || sender.t1_deadline < next)) {
+		next = sender.t1_deadline;
+	}
+
+	return next;
+}
+
+//--------------------------------------------------
+static int run(const run_config_t *config, uint64_t seed, run_result_t *result)
+{
+	const hdlc_sim_config_t channel_config = {
+		.seed = seed,
+		.bit_error_rate = config->bit_error_rate,
+		.latency = LATENCY,
+		.bandwidth = BANDWIDTH,
+	};
+
+	hdlc_sim_config_t reverse_config = channel_config;
+	reverse_config.seed = ~seed;
+
+	if (hdlc_sim_channel_init(&forward_channel, &channel_config) < 0 ||
+	    hdlc_sim_channel_init(&reverse_channel, &reverse_config) < 0) {
+		return -1;
+	}
+
+	memset(&sender, 0, sizeof(sender));
+	memset(&receiver, 0, sizeof(receiver));
+
+	hdlc_timer_wheel_init(&wheel, 0);
+	hdlc_timer_init(&sender.t1, t1_expired, &sender);
+	hdlc_retx_store_init(&sender.store);
+	hdlc_rtt_init(&sender.rtt, INITIAL_RTO, MIN_RTO, MAX_RTO);
+
+	hdlc_deframer_init(&sender.deframer, &sender.rx_frame, sender_on_frame, &sender);
+	hdlc_deframer_init(&receiver.deframer, &receiver.rx_frame, receiver_on_frame, &receiver);
+
+	hdlc_sim_time_t now = 0;
+
+	if (sender_fill_window(&sender, config, now) < 0) {
+		return -1;
+	}
+
+	while (receiver.delivered < payload_len || sender.outstanding > 0) {
+		const hdlc_sim_time_t next = next_event();
+		if (next == 0 || next > TIME_LIMIT) {
+			break;
+		}
+
+		if (next > now) {
+			now = next;
+		}
+
+		process_forward(now);
+
+		if (receiver.ack_pending && receiver_send_ack(&receiver, now) < 0) {
+			return -1;
+		}
+
+		process_reverse(now);
+
+		hdlc_timer_wheel_advance(&wheel, to_tick(now));
+
+		if (sender.timed_out && sender_retransmit(&sender, now) < 0) {
+			return -1;
+		}
+
+		if (sender_fill_window(&sender, config, now) < 0) {
+			return -1;
+		}
+	}
+
+	result->elapsed = now;
+	result->delivered = receiver.delivered;
+	result->completed = (receiver.delivered == payload_len && sender.outstanding == 0);
+
+	return 0;
+}
+
+//--------------------------------------------------
+static void print_header(void)
+{
+	printf("ber,window,frame_size,payload_bytes,time_s,goodput_bps,efficiency,frames,"
+	       "retransmissions,retx_overhead,timeouts,wire_bytes,completed\n");
+}
+
+//--------------------------------------------------
+static void print_result(const run_config_t *config, const run_result_t *result)
+{
+	const double seconds = (double)result->elapsed / 1e9;
+	const double goodput = seconds > 0.0 ? (double)result->delivered * 8.0 / seconds : 0.0;
+	const double overhead =
+		sender.frames > 0 ? (double)sender.retransmissions / (double)sender.frames : 0.0;
+
+	printf("%g,%d,%d,%zu,%.6f,%.0f,%.4f,%llu,%llu,%.4f,%llu,%llu,%d\n",
+	       config->bit_error_rate, config->window, config->frame_size, result->delivered,
+	       seconds, goodput, goodput / BANDWIDTH, (unsigned long long)sender.frames,
+	       (unsigned long long)sender.retransmissions, overhead,
+	       (unsigned long long)sender.timeouts, (unsigned long long)sender.wire_bytes,
+	       result->completed);
+}
+
+//--------------------------------------------------
+int main(int argc, char *argv[])
+{
+	payload_len = DEFAULT_BYTES;
+	uint64_t seed = DEFAULT_SEED;
+
+	if (argc > 3) {
+		fprintf(stderr, "Usage: %s [payload_bytes] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	if (argc > 1) {
+		payload_len = strtoul(argv[1], NULL, 0);
+	}
+
+	if (argc > 2) {
+		seed = strtoull(argv[2], NULL, 0);
+	}
+
+	if (payload_len == 0) {
+		fprintf(stderr, "Payload must not be empty\n");
+		return 1;
+	}
+
+	payload = malloc(payload_len);
+	if (payload == NULL) {
+		fprintf(stderr, "Failed to allocate payload\n");
+		return 1;
+	}
+
+	// Pseudo random payload so stuffing overhead looks like real traffic
+	uint32_t state = (uint32_t)seed | 1;
+	for (size_t i = 0; i < payload_len; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		payload[i] = (uint8_t)state;
+	}
+
+	print_header();
+
+	int run_index = 0;
+
+	for (int b = 0; b < COUNT(bit_error_rates); b++) {
+		for (int w = 0; w < COUNT(windows); w++) {
+			for (int f = 0; f < COUNT(frame_sizes); f++) {
+				const run_config_t config = {
+					.bit_error_rate = bit_error_rates[b],
+					.window = windows[w],
+					.frame_size = frame_sizes[f],
+				};
+
+				run_result_t result = {0};
+
+				if (run(&config, seed + (uint64_t)run_index++, &result) < 0) {
+					fprintf(stderr, "Run failed\n");
+					free(payload);
+					return 1;
+				}
+
+				print_result(&config, &result);
+			}
+		}
+	}
+
+	free(payload);
+	return 0;
+}
\ No newline at end of file
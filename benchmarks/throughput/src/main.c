@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <hdlc.h>
+#include <hdlc_deframer.h>
+#include <hdlc_dispatch.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ADDRESS 0x03
+
+#define FRAME_COUNT    64 // Frames per stream, and per call to hdlc_encode_batch
+#define DEFAULT_MBYTES 16 // Wire bytes per measurement
+#define DEFAULT_SEED   0x5EED
+
+static const int frame_sizes[] = {16, 64, 255};
+static const int escape_ratios[] = {0, 64, 8}; // One in N information bytes escaped, 0 for none
+
+#define COUNT(array) ((int)(sizeof(array) / sizeof((array)[0])))
+
+typedef struct {
+	double encode;
+	double batch_encode;
+	double deframe;
+} run_result_t;
+
+// Frames and the stream they encode to are large, keep them off the stack
+static hdlc_frame_t frames[FRAME_COUNT];
+static uint8_t encoded[FRAME_COUNT][HDLC_ENCODED_MAX_LEN];
+static uint8_t stream[FRAME_COUNT * HDLC_ENCODED_MAX_LEN];
+static int stream_len;
+
+static size_t budget;
+static uint64_t random_state;
+
+//--------------------------------------------------
+static uint32_t next_random(void)
+{
+	random_state = random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (uint32_t)(random_state >> 33);
+}
+
+//--------------------------------------------------
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//--------------------------------------------------
+static double to_mbps(size_t bytes, double seconds)
+{
+	return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+// Random information bytes where one in escape_ratio is a flag or an escape byte
+//--------------------------------------------------
+static int prepare(int frame_size, int escape_ratio)
+{
+	stream_len = 0;
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		hdlc_frame_t *frame = &frames[i];
+
+		hdlc_frame_init(frame);
+		frame->address = ADDRESS;
+		hdlc_i_frame_control_init(&frame->control, i & 0x07, 0, (i + 1) & 0x07);
+		frame->info_len = (hdlc_info_len_t)frame_size;
+
+		for (int j = 0; j < frame_size; j++) {
+			uint8_t byte = (uint8_t)next_random();
+
+			if (byte == 0x7E || byte == 0x7D) {
+				byte = 0x00;
+			}
+
+			if (escape_ratio != 0 && next_random() % escape_ratio == 0) {
+				byte = (next_random() & 1) ? 0x7E : 0x7D;
+			}
+
+			frame->info[j] = byte;
+		}
+
+		const int len = hdlc_encode(frame, stream + stream_len, sizeof(stream) - stream_len);
+		if (len < 0) {
+			fprintf(stderr, "Failed to encode frame\n");
+			return -1;
+		}
+
+		stream_len += len;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+static double measure_encode(void)
+{
+	size_t bytes = 0;
+	const double start = now_seconds();
+
+	while (bytes < budget) {
+		for (int i = 0; i < FRAME_COUNT; i++) {
+			const int len = hdlc_encode(&frames[i], encoded[i], HDLC_ENCODED_MAX_LEN);
+			if (len < 0) {
+				return 0;
+			}
+
+			bytes += len;
+		}
+	}
+
+	return to_mbps(bytes, now_seconds() - start);
+}
+
+//--------------------------------------------------
+static double measure_batch_encode(void)
+{
+	uint8_t *data[FRAME_COUNT];
+	int len[FRAME_COUNT];
+	int encoded_lens[FRAME_COUNT];
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		data[i] = encoded[i];
+		len[i] = HDLC_ENCODED_MAX_LEN;
+	}
+
+	size_t bytes = 0;
+	const double start = now_seconds();
+
+	while (bytes < budget) {
+		if (hdlc_encode_batch(frames, FRAME_COUNT, data, len, encoded_lens) < 0) {
+			return 0;
+		}
+
+		for (int i = 0; i < FRAME_COUNT; i++) {
+			bytes += encoded_lens[i];
+		}
+	}
+
+	return to_mbps(bytes, now_seconds() - start);
+}
+
+//--------------------------------------------------
+static double measure_deframe(void)
+{
+	hdlc_frame_t frame;
+	hdlc_deframer_t deframer;
+
+	if (hdlc_deframer_init(&deframer, &frame, NULL, NULL) < 0) {
+		return 0;
+	}
+
+	size_t bytes = 0;
+	const double start = now_seconds();
+
+	while (bytes < budget) {
+		if (hdlc_deframer_push(&deframer, stream, stream_len) != FRAME_COUNT) {
+			fprintf(stderr, "Deframer lost frames\n");
+			return 0;
+		}
+
+		bytes += stream_len;
+	}
+
+	return to_mbps(bytes, now_seconds() - start);
+}
+
+//--------------------------------------------------
+static void print_header(void)
+{
+	printf("kernels,frame_size,escape_ratio,encode_mbps,batch_encode_mbps,deframe_mbps\n");
+}
+
+//--------------------------------------------------
+static void print_result(hdlc_kernels_id_t kernels, int frame_size, int escape_ratio,
+			 const run_result_t *result)
+{
+	printf("%s,%d,%d,%.1f,%.1f,%.1f\n", hdlc_dispatch_name(kernels), frame_size, escape_ratio,
+	       result->encode, result->batch_encode, result->deframe);
+}
+
+//--------------------------------------------------
+int main(int argc, char *argv[])
+{
+	budget = (size_t)DEFAULT_MBYTES * 1000000;
+	random_state = DEFAULT_SEED;
+
+	if (argc > 2) {
+		fprintf(stderr, "Usage: %s [mbytes]\n", argv[0]);
+		return 1;
+	}
+
+	if (argc > 1) {
+		budget = strtoul(argv[1], NULL, 0) * 1000000;
+	}
+
+	if (budget == 0) {
+		fprintf(stderr, "Budget must not be empty\n");
+		return 1;
+	}
+
+	print_header();
+
+	for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+		const hdlc_kernels_id_t kernels = (hdlc_kernels_id_t)id;
+
+		// Every kernel set the CPU can run, so each of them gets measured and trained
+		if (hdlc_dispatch_select(kernels) < 0) {
+			continue;
+		}
+
+		for (int s = 0; s < COUNT(frame_sizes); s++) {
+			for (int e = 0; e < COUNT(escape_ratios); e++) {
+				if (prepare(frame_sizes[s], escape_ratios[e]) < 0) {
+					return 1;
+				}
+
+				run_result_t result;
+				result.encode = measure_encode();
+				result.batch_encode = measure_batch_encode();
+				result.deframe = measure_deframe();
+
+				print_result(kernels, frame_sizes[s], escape_ratios[e], &result);
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <hdlc.h>
+#include <hdlc_deframer.h>
+
+#include <stdint.h>
+
+// Frames moved per system call in either direction
+#ifndef HDLC_BRIDGE_BATCH
+#define HDLC_BRIDGE_BATCH 32
+#endif
+
+// On IP a frame is its address, control and information bytes. UDP carries one frame per
+// datagram, on TCP every frame is preceded by its length as two bytes, high byte first.
+#define HDLC_BRIDGE_FRAME_MAX  (2 + HDLC_INFO_MAX_LEN)
+#define HDLC_BRIDGE_PREFIX_LEN 2
+
+typedef enum {
+	HDLC_BRIDGE_UDP,
+	HDLC_BRIDGE_TCP,
+} hdlc_bridge_transport_t;
+
+typedef struct {
+	uint64_t frames_out; // Frames taken from the channel and sent over IP
+	uint64_t frames_in;  // Frames received over IP and encoded for the channel
+	uint64_t send_calls;
+	uint64_t recv_calls;
+	uint64_t dropped;   // Frames from the channel that found the send queue full
+	uint64_t malformed; // Datagrams too short or too long for a frame
+} hdlc_bridge_stats_t;
+
+typedef struct {
+	int fd;
+	hdlc_bridge_transport_t transport;
+	hdlc_bridge_stats_t stats;
+
+	// Channel to IP: the deframer decodes straight into the next free slot of the send queue
+	hdlc_deframer_t deframer;
+	hdlc_frame_t out[HDLC_BRIDGE_BATCH];
+	uint8_t out_prefix[HDLC_BRIDGE_BATCH][HDLC_BRIDGE_PREFIX_LEN];
+	int out_first;
+	int out_count;
+	int out_offset; // Bytes of the first queued TCP record already written
+	int error;
+
+	// IP to channel: received frames are encoded on demand as the channel takes bytes
+	hdlc_frame_t in[HDLC_BRIDGE_BATCH];
+	int in_next;
+	int in_count;
+	hdlc_encoder_t encoder;
+	int encoding;
+	uint8_t stream[HDLC_BRIDGE_BATCH * (HDLC_BRIDGE_PREFIX_LEN + HDLC_BRIDGE_FRAME_MAX)];
+	int stream_len;
+} hdlc_bridge_t;
+
+// The socket is connected and owned by the caller. Receiving never blocks, sending blocks only
+// when the socket itself is blocking.
+int hdlc_bridge_init(hdlc_bridge_t *bridge, int fd, hdlc_bridge_transport_t transport);
+int hdlc_bridge_push(hdlc_bridge_t *bridge, const uint8_t *data, int len);
+int hdlc_bridge_pull(hdlc_bridge_t *bridge, uint8_t *data, int len);
+int hdlc_bridge_flush(hdlc_bridge_t *bridge);
+int hdlc_bridge_pending(const hdlc_bridge_t *bridge);
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "hdlc_bridge.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#if HDLC_BRIDGE_BATCH < 2
+#error "HDLC_BRIDGE_BATCH must be at least 2"
+#endif
+
+// Frames go on and come off the socket in place, address, control and information are adjacent
+_Static_assert(offsetof(hdlc_frame_t, info) == 2, "hdlc_frame_t layout");
+_Static_assert(offsetof(hdlc_frame_t, info_len) == HDLC_BRIDGE_FRAME_MAX, "hdlc_frame_t layout");
+
+//--------------------------------------------------
+static int _hdlc_bridge_frame_len(const hdlc_frame_t *frame)
+{
+	return 2 + frame->info_len;
+}
+
+//--------------------------------------------------
+static int _hdlc_bridge_would_block(void)
+{
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+// Moves the frames still queued and the one being decoded to the front of the send queue
+//--------------------------------------------------
+static void _hdlc_bridge_compact(hdlc_bridge_t *bridge)
+{
+	const int first = bridge->out_first;
+	if (first == 0) {
+		return;
+	}
+
+	const int count = bridge->out_count - first;
+	const int slots = bridge->out_count < HDLC_BRIDGE_BATCH ? count + 1 : count;
+
+	memmove(bridge->out, bridge->out + first, slots * sizeof(bridge->out[0]));
+	memmove(bridge->out_prefix, bridge->out_prefix + first, count * sizeof(bridge->out_prefix[0]));
+
+	bridge->out_first = 0;
+	bridge->out_count = count;
+	bridge->deframer.frame = &bridge->out[count];
+}
+
+// One datagram per frame, as many as the socket takes in one call
+//--------------------------------------------------
+static int _hdlc_bridge_send_udp(hdlc_bridge_t *bridge)
+{
+	struct mmsghdr msgs[HDLC_BRIDGE_BATCH];
+	struct iovec iov[HDLC_BRIDGE_BATCH];
+
+	const int count = bridge->out_count - bridge->out_first;
+
+	memset(msgs, 0, count * sizeof(msgs[0]));
+
+	for (int i = 0; i < count; i++) {
+		hdlc_frame_t *frame = &bridge->out[bridge->out_first + i];
+
+		iov[i].iov_base = frame;
+		iov[i].iov_len = _hdlc_bridge_frame_len(frame);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	bridge->stats.send_calls++;
+
+	return sendmmsg(bridge->fd, msgs, count, 0);
+}
+
+// Every queued record in one gathered write, a partial write resumes inside the first record
+//--------------------------------------------------
+static int _hdlc_bridge_send_tcp(hdlc_bridge_t *bridge)
+{
+	struct iovec iov[2 * HDLC_BRIDGE_BATCH];
+	int iov_count = 0;
+
+	for (int i = bridge->out_first; i < bridge->out_count; i++) {
+		iov[iov_count].iov_base = bridge->out_prefix[i];
+		iov[iov_count++].iov_len = HDLC_BRIDGE_PREFIX_LEN;
+		iov[iov_count].iov_base = &bridge->out[i];
+		iov[iov_count++].iov_len = _hdlc_bridge_frame_len(&bridge->out[i]);
+	}
+
+	// Skip what an earlier call already wrote of the first record
+	int skip = bridge->out_offset;
+	int first_iov = 0;
+
+	while (skip >= (int)iov[first_iov].iov_len) {
+		skip -= iov[first_iov++].iov_len;
+	}
+
+	iov[first_iov].iov_base = (uint8_t *)iov[first_iov].iov_base + skip;
+	iov[first_iov].iov_len -= skip;
+
+	struct msghdr msg = {0};
+	msg.msg_iov = iov + first_iov;
+	msg.msg_iovlen = iov_count - first_iov;
+
+	bridge->stats.send_calls++;
+
+	const ssize_t result = sendmsg(bridge->fd, &msg, MSG_NOSIGNAL);
+	if (result < 0) {
+		return -1;
+	}
+
+	// Count the records that are now completely on their way
+	size_t left = (size_t)result + bridge->out_offset;
+	int frames = 0;
+
+	while (bridge->out_first + frames < bridge->out_count) {
+		const size_t record_len =
+			HDLC_BRIDGE_PREFIX_LEN +
+			_hdlc_bridge_frame_len(&bridge->out[bridge->out_first + frames]);
+
+		if (left < record_len) {
+			break;
+		}
+
+		left -= record_len;
+		frames++;
+	}
+
+	bridge->out_offset = (int)left;
+
+	return frames;
+}
+
+// Called for every frame decoded from the channel, which is already in its send queue slot
+//--------------------------------------------------
+static void _hdlc_bridge_on_frame(void *user, const hdlc_frame_desc_t *desc)
+{
+	hdlc_bridge_t *bridge = user;
+	const int len = _hdlc_bridge_frame_len(desc->frame);
+
+	bridge->out_prefix[bridge->out_count][0] = (uint8_t)(len >> 8);
+	bridge->out_prefix[bridge->out_count][1] = (uint8_t)len;
+	bridge->out_count++;
+
+	if (bridge->out_count == HDLC_BRIDGE_BATCH) {
+		if (hdlc_bridge_flush(bridge) < 0) {
+			bridge->error = 1;
+		}
+
+		// Nothing could be sent, the newest frame makes room for the next one
+		if (bridge->out_count == HDLC_BRIDGE_BATCH) {
+			bridge->out_count--;
+			bridge->stats.dropped++;
+		}
+	}
+
+	bridge->deframer.frame = &bridge->out[bridge->out_count];
+}
+
+// Takes everything the socket holds right now, up to a batch of frames
+//--------------------------------------------------
+static int _hdlc_bridge_receive_udp(hdlc_bridge_t *bridge)
+{
+	struct mmsghdr msgs[HDLC_BRIDGE_BATCH];
+	struct iovec iov[HDLC_BRIDGE_BATCH];
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (int i = 0; i < HDLC_BRIDGE_BATCH; i++) {
+		iov[i].iov_base = &bridge->in[i];
+		iov[i].iov_len = HDLC_BRIDGE_FRAME_MAX;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	bridge->stats.recv_calls++;
+
+	const int result = recvmmsg(bridge->fd, msgs, HDLC_BRIDGE_BATCH, MSG_DONTWAIT, NULL);
+	if (result < 0) {
+		return (_hdlc_bridge_would_block() || errno == EINTR) ? 0 : -1;
+	}
+
+	int count = 0;
+
+	for (int i = 0; i < result; i++) {
+		const int len = (int)msgs[i].msg_len;
+
+		if (len < 2 || (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+			bridge->stats.malformed++;
+			continue;
+		}
+
+		if (count != i) {
+			memcpy(&bridge->in[count], &bridge->in[i], len);
+		}
+
+		bridge->in[count++].info_len = (hdlc_info_len_t)(len - 2);
+	}
+
+	bridge->in_next = 0;
+	bridge->in_count = count;
+
+	// Datagrams that were all malformed still count as progress
+	return result;
+}
+
+// Cuts complete records off the front of the TCP stream
+//--------------------------------------------------
+static int _hdlc_bridge_parse_tcp(hdlc_bridge_t *bridge)
+{
+	int offset = 0;
+	int count = 0;
+
+	while (count < HDLC_BRIDGE_BATCH && bridge->stream_len - offset >= HDLC_BRIDGE_PREFIX_LEN) {
+		const int len = (bridge->stream[offset] << 8) | bridge->stream[offset + 1];
+
+		// Without a valid length the records can not be found again
+		if (len < 2 || len > HDLC_BRIDGE_FRAME_MAX) {
+			bridge->stats.malformed++;
+			return -1;
+		}
+
+		if (bridge->stream_len - offset - HDLC_BRIDGE_PREFIX_LEN < len) {
+			break;
+		}
+
+		memcpy(&bridge->in[count], bridge->stream + offset + HDLC_BRIDGE_PREFIX_LEN, len);
+		bridge->in[count++].info_len = (hdlc_info_len_t)(len - 2);
+
+		offset += HDLC_BRIDGE_PREFIX_LEN + len;
+	}
+
+	memmove(bridge->stream, bridge->stream + offset, bridge->stream_len - offset);
+	bridge->stream_len -= offset;
+
+	bridge->in_next = 0;
+	bridge->in_count = count;
+
+	return count;
+}
+
+// Records already buffered go first, the buffer always has room for one more once they are out
+//--------------------------------------------------
+static int _hdlc_bridge_receive_tcp(hdlc_bridge_t *bridge)
+{
+	const int parsed = _hdlc_bridge_parse_tcp(bridge);
+	if (parsed != 0) {
+		return parsed;
+	}
+
+	bridge->stats.recv_calls++;
+
+	const ssize_t result = recv(bridge->fd, bridge->stream + bridge->stream_len,
+				    sizeof(bridge->stream) - bridge->stream_len, MSG_DONTWAIT);
+	if (result < 0) {
+		return (_hdlc_bridge_would_block() || errno == EINTR) ? 0 : -1;
+	}
+
+	// Closed by the peer
+	if (result == 0) {
+		return -1;
+	}
+
+	bridge->stream_len += (int)result;
+
+	return _hdlc_bridge_parse_tcp(bridge);
+}
+
+//--------------------------------------------------
+int hdlc_bridge_init(hdlc_bridge_t *bridge, int fd, hdlc_bridge_transport_t transport)
+{
+	if (bridge == NULL || fd < 0) {
+		return -1;
+	}
+
+	if (transport != HDLC_BRIDGE_UDP && transport != HDLC_BRIDGE_TCP) {
+		return -1;
+	}
+
+	memset(bridge, 0, sizeof(*bridge));
+
+	bridge->fd = fd;
+	bridge->transport = transport;
+
+	return hdlc_deframer_init(&bridge->deframer, &bridge->out[0], _hdlc_bridge_on_frame,
+				  bridge);
+}
+
+// Decodes bytes read from the channel and sends the frames found in them, all in as few calls
+// as the socket allows. Returns the number of frames found.
+//--------------------------------------------------
+int hdlc_bridge_push(hdlc_bridge_t *bridge, const uint8_t *data, int len)
+{
+	if (bridge == NULL || data == NULL || len < 0) {
+		return -1;
+	}
+
+	const int frames = hdlc_deframer_push(&bridge->deframer, data, len);
+	if (frames < 0) {
+		return -1;
+	}
+
+	if (hdlc_bridge_flush(bridge) < 0 || bridge->error) {
+		bridge->error = 0;
+		return -1;
+	}
+
+	return frames;
+}
+
+// Fills data with the encoded frames received over IP, returns 0 when there are none
+//--------------------------------------------------
+int hdlc_bridge_pull(hdlc_bridge_t *bridge, uint8_t *data, int len)
+{
+	if (bridge == NULL || data == NULL || len < 0) {
+		return -1;
+	}
+
+	int written = 0;
+
+	while (written < len) {
+		if (!bridge->encoding) {
+			if (bridge->in_next == bridge->in_count) {
+				const int result = bridge->transport == HDLC_BRIDGE_UDP
+							   ? _hdlc_bridge_receive_udp(bridge)
+							   : _hdlc_bridge_receive_tcp(bridge);
+
+				// Hand out what is encoded already, the error is seen again next time
+				if (result < 0) {
+					return written > 0 ? written : -1;
+				}
+
+				if (result == 0) {
+					break;
+				}
+
+				continue;
+			}
+
+			hdlc_encoder_init(&bridge->encoder, &bridge->in[bridge->in_next]);
+			bridge->encoding = 1;
+		}
+
+		const int result = hdlc_encoder_pull(&bridge->encoder, data + written, len - written);
+		if (result < 0) {
+			return -1;
+		}
+
+		written += result;
+
+		if (hdlc_encoder_done(&bridge->encoder)) {
+			bridge->encoding = 0;
+			bridge->in_next++;
+			bridge->stats.frames_in++;
+		}
+	}
+
+	return written;
+}
+
+// Sends what is still queued, returns the number of frames the socket did not take yet
+//--------------------------------------------------
+int hdlc_bridge_flush(hdlc_bridge_t *bridge)
+{
+	if (bridge == NULL) {
+		return -1;
+	}
+
+	while (bridge->out_first < bridge->out_count) {
+		const int result = bridge->transport == HDLC_BRIDGE_UDP ? _hdlc_bridge_send_udp(bridge)
+									: _hdlc_bridge_send_tcp(bridge);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			if (_hdlc_bridge_would_block()) {
+				break;
+			}
+
+			_hdlc_bridge_compact(bridge);
+			return -1;
+		}
+
+		bridge->out_first += result;
+		bridge->stats.frames_out += result;
+	}
+
+	_hdlc_bridge_compact(bridge);
+
+	return bridge->out_count;
+}
+
+//--------------------------------------------------
+int hdlc_bridge_pending(const hdlc_bridge_t *bridge)
+{
+	if (bridge == NULL) {
+		return -1;
+	}
+
+	return bridge->out_count - bridge->out_first;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <hdlc.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Entry point called by libFuzzer, or by the standalone driver when libFuzzer is unavailable
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+// Aborts so the fuzzer keeps the input that made the library and the reference disagree
+#define FUZZ_CHECK(cond)                                                                           \
+	do {                                                                                       \
+		if (!(cond)) {                                                                     \
+			fprintf(stderr, "[%s:%d] Divergence: %s\n", __func__, __LINE__, #cond);    \
+			abort();                                                                   \
+		}                                                                                  \
+	} while (0)
+
+//--------------------------------------------------
+static inline int fuzz_frames_equal(const hdlc_frame_t *a, const hdlc_frame_t *b)
+{
+	return a->address == b->address && a->control.value == b->control.value &&
+	       a->info_len == b->info_len && memcmp(a->info, b->info, a->info_len) == 0;
+}
+
+// Copies the input into an allocation of exactly its size so reads past the end are caught
+//--------------------------------------------------
+static inline uint8_t *fuzz_dup(const uint8_t *data, size_t size)
+{
+	uint8_t *copy = malloc(size > 0 ? size : 1);
+	if (copy != NULL && size > 0) {
+		memcpy(copy, data, size);
+	}
+
+	return copy;
+}
\ No newline at end of file
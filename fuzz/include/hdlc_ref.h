@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <hdlc.h>
+#include <hdlc_deframer.h>
+
+// Frozen byte-at-a-time copy of the codec that optimized paths in the library are checked
+// against. Do not optimize or otherwise change this, it defines the expected behavior.
+
+uint16_t hdlc_ref_calculate_fcs(const uint8_t *data, int len);
+
+int hdlc_ref_encode(const hdlc_frame_t *frame, uint8_t *data, int len);
+int hdlc_ref_decode(hdlc_frame_t *frame, const uint8_t *data, int len);
+
+// Stream deframer taking one byte at a time, with every frame kept both as sent and unstuffed
+typedef struct {
+	hdlc_deframer_cb_t cb;
+	void *user;
+	hdlc_deframer_stats_t stats;
+	hdlc_deframer_state_t state;
+	uint8_t raw[HDLC_ENCODED_MAX_LEN]; // Bytes on the line after the opening flag
+	int raw_len;
+	uint8_t bytes[HDLC_INFO_MAX_LEN + 4]; // Unstuffed address, control, information and FCS
+	int starts[HDLC_INFO_MAX_LEN + 4];    // Where each of them starts in raw
+	int bytes_len;
+} hdlc_ref_deframer_t;
+
+void hdlc_ref_deframer_init(hdlc_ref_deframer_t *deframer, hdlc_deframer_cb_t cb, void *user);
+void hdlc_ref_deframer_push(hdlc_ref_deframer_t *deframer, uint8_t byte);
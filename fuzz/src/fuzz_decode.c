@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "fuzz.h"
+#include "hdlc_ref.h"
+
+#include <hdlc_deframer.h>
+#include <hdlc_dispatch.h>
+
+// Input layout: mode byte, then either raw bytes to decode or a frame followed by corruptions
+
+#define RECORD_FRAMES 16
+
+typedef struct {
+	hdlc_frame_t frames[RECORD_FRAMES];
+	int encoded_lens[RECORD_FRAMES];
+	int count;
+	hdlc_deframer_stats_t stats;
+} fuzz_record_t;
+
+//--------------------------------------------------
+static void _fuzz_record_frame(void *user, const hdlc_frame_desc_t *desc)
+{
+	fuzz_record_t *record = user;
+
+	if (record->count < RECORD_FRAMES) {
+		record->frames[record->count] = *desc->frame;
+		record->encoded_lens[record->count] = desc->encoded_len;
+	}
+
+	record->count++;
+}
+
+//--------------------------------------------------
+static void _fuzz_deframe(const uint8_t *data, int len, int chunk, fuzz_record_t *record)
+{
+	hdlc_frame_t frame;
+	hdlc_deframer_t deframer;
+
+	memset(record, 0, sizeof(*record));
+
+	FUZZ_CHECK(hdlc_deframer_init(&deframer, &frame, _fuzz_record_frame, record) == 0);
+
+	int delivered = 0;
+	for (int offset = 0; offset < len; offset += chunk) {
+		const int result =
+			hdlc_deframer_push(&deframer, data + offset, len - offset < chunk ? len - offset : chunk);
+		FUZZ_CHECK(result >= 0);
+		delivered += result;
+	}
+
+	FUZZ_CHECK(delivered == record->count);
+	FUZZ_CHECK(deframer.stats.frames == (uint32_t)record->count);
+
+	record->stats = deframer.stats;
+}
+
+//--------------------------------------------------
+static void _fuzz_ref_deframe(const uint8_t *data, int len, fuzz_record_t *record)
+{
+	static hdlc_ref_deframer_t deframer;
+
+	memset(record, 0, sizeof(*record));
+
+	hdlc_ref_deframer_init(&deframer, _fuzz_record_frame, record);
+
+	for (int i = 0; i < len; i++) {
+		hdlc_ref_deframer_push(&deframer, data[i]);
+	}
+
+	record->stats = deframer.stats;
+}
+
+//--------------------------------------------------
+static void _fuzz_records_compare(const fuzz_record_t *live, const fuzz_record_t *ref)
+{
+	FUZZ_CHECK(live->count == ref->count);
+
+	for (int i = 0; i < live->count && i < RECORD_FRAMES; i++) {
+		FUZZ_CHECK(fuzz_frames_equal(&live->frames[i], &ref->frames[i]));
+		FUZZ_CHECK(live->encoded_lens[i] == ref->encoded_lens[i]);
+	}
+
+	FUZZ_CHECK(live->stats.frames == ref->stats.frames);
+	FUZZ_CHECK(live->stats.fcs_errors == ref->stats.fcs_errors);
+	FUZZ_CHECK(live->stats.aborts == ref->stats.aborts);
+	FUZZ_CHECK(live->stats.escape_errors == ref->stats.escape_errors);
+	FUZZ_CHECK(live->stats.length_errors == ref->stats.length_errors);
+}
+
+// Every kernel set the CPU supports, whole or in pieces, must deframe like the reference
+//--------------------------------------------------
+static void _fuzz_decode_stream(const uint8_t *data, int len, int chunk)
+{
+	static fuzz_record_t ref;
+	static fuzz_record_t live;
+
+	uint8_t *copy = fuzz_dup(data, len);
+	if (copy == NULL) {
+		return;
+	}
+
+	_fuzz_ref_deframe(copy, len, &ref);
+
+	const hdlc_kernels_id_t active = hdlc_dispatch_active();
+
+	for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+		if (!hdlc_dispatch_supported((hdlc_kernels_id_t)id)) {
+			continue;
+		}
+
+		FUZZ_CHECK(hdlc_dispatch_select((hdlc_kernels_id_t)id) == 0);
+
+		_fuzz_deframe(copy, len, len > 0 ? len : 1, &live);
+		_fuzz_records_compare(&live, &ref);
+
+		_fuzz_deframe(copy, len, chunk, &live);
+		_fuzz_records_compare(&live, &ref);
+	}
+
+	FUZZ_CHECK(hdlc_dispatch_select(active) == 0);
+
+	free(copy);
+}
+
+//--------------------------------------------------
+static void _fuzz_decode_compare(const uint8_t *data, int len)
+{
+	uint8_t *live_data = fuzz_dup(data, len);
+	uint8_t *ref_data = fuzz_dup(data, len);
+
+	if (live_data != NULL && ref_data != NULL) {
+		hdlc_frame_t live_frame;
+		hdlc_frame_t ref_frame;
+		hdlc_frame_init(&live_frame);
+		hdlc_frame_init(&ref_frame);
+
+		const int live_result = hdlc_decode(&live_frame, live_data, len);
+		const int ref_result = hdlc_ref_decode(&ref_frame, ref_data, len);
+
+		FUZZ_CHECK(live_result == ref_result);
+		FUZZ_CHECK(live_result < 0 || fuzz_frames_equal(&live_frame, &ref_frame));
+	}
+
+	free(live_data);
+	free(ref_data);
+}
+
+// Random bytes rarely carry a valid FCS, so also start from a real frame and damage it
+//--------------------------------------------------
+static void _fuzz_decode_corrupted(const uint8_t *data, size_t size, int chunk)
+{
+	if (size < 3) {
+		return;
+	}
+
+	hdlc_frame_t frame;
+	hdlc_frame_init(&frame);
+
+	frame.address = data[0];
+	frame.control.value = data[1];
+	const int info_len = data[2];
+	frame.info_len = info_len > HDLC_INFO_MAX_LEN ? HDLC_INFO_MAX_LEN : info_len;
+
+	data += 3;
+	size -= 3;
+
+	if (frame.info_len > size) {
+		frame.info_len = (hdlc_info_len_t)size;
+	}
+
+	memcpy(frame.info, data, frame.info_len);
+
+	data += frame.info_len;
+	size -= frame.info_len;
+
+	uint8_t encoded[HDLC_ENCODED_MAX_LEN + 8];
+	int encoded_len = hdlc_ref_encode(&frame, encoded, HDLC_ENCODED_MAX_LEN);
+	FUZZ_CHECK(encoded_len > 0);
+
+	// Each remaining pair is (position, xor mask), a zero mask truncates the frame instead
+	for (; size >= 2; data += 2, size -= 2) {
+		const int position = data[0] % encoded_len;
+
+		if (data[1] == 0) {
+			encoded_len = position;
+		} else {
+			encoded[position] ^= data[1];
+		}
+
+		if (encoded_len == 0) {
+			break;
+		}
+	}
+
+	_fuzz_decode_compare(encoded, encoded_len);
+	_fuzz_decode_stream(encoded, encoded_len, chunk);
+}
+
+//--------------------------------------------------
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	if (size < 1) {
+		return 0;
+	}
+
+	const int chunk = (data[0] >> 1) + 1;
+
+	if (data[0] & 1) {
+		_fuzz_decode_compare(data + 1, (int)(size - 1));
+		_fuzz_decode_stream(data + 1, (int)(size - 1), chunk);
+	} else {
+		_fuzz_decode_corrupted(data + 1, size - 1, chunk);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "fuzz.h"
+#include "hdlc_ref.h"
+
+// Input layout: buffer size selector, new control byte, address, control, information bytes
+
+#define BATCH_MAX 5
+
+//--------------------------------------------------
+static void _fuzz_encode_one_shot(const hdlc_frame_t *frame, int size)
+{
+	uint8_t *live = malloc(size > 0 ? size : 1);
+	uint8_t *ref = malloc(size > 0 ? size : 1);
+
+	if (live != NULL && ref != NULL) {
+		const int live_len = hdlc_encode(frame, live, size);
+		const int ref_len = hdlc_ref_encode(frame, ref, size);
+
+		FUZZ_CHECK(live_len == ref_len);
+		FUZZ_CHECK(live_len < 0 || memcmp(live, ref, live_len) == 0);
+	}
+
+	free(live);
+	free(ref);
+}
+
+//--------------------------------------------------
+static void _fuzz_encode_resumable(const hdlc_frame_t *frame, const uint8_t *expected,
+				   int expected_len, int chunk)
+{
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+	hdlc_encoder_t encoder;
+
+	FUZZ_CHECK(hdlc_encoder_init(&encoder, frame) == 0);
+
+	int len = 0;
+	while (!hdlc_encoder_done(&encoder)) {
+		const int room = (int)sizeof(buffer) - len < chunk ? (int)sizeof(buffer) - len : chunk;
+		FUZZ_CHECK(room > 0);
+
+		const int result = hdlc_encoder_pull(&encoder, buffer + len, room);
+		FUZZ_CHECK(result >= 0);
+
+		len += result;
+	}
+
+	FUZZ_CHECK(len == expected_len);
+	FUZZ_CHECK(memcmp(buffer, expected, len) == 0);
+}
+
+// Batches of prefixes of the frame, so the FCS lanes run out at different points
+//--------------------------------------------------
+static void _fuzz_encode_batch(const hdlc_frame_t *frame, int count)
+{
+	hdlc_frame_t frames[BATCH_MAX];
+	uint8_t buffers[BATCH_MAX][HDLC_ENCODED_MAX_LEN];
+	uint8_t *data[BATCH_MAX];
+	int len[BATCH_MAX];
+	int encoded_lens[BATCH_MAX];
+
+	for (int i = 0; i < count; i++) {
+		frames[i] = *frame;
+		frames[i].info_len = (hdlc_info_len_t)(frame->info_len * (count - i) / count);
+		data[i] = buffers[i];
+		len[i] = HDLC_ENCODED_MAX_LEN;
+	}
+
+	FUZZ_CHECK(hdlc_encode_batch(frames, count, data, len, encoded_lens) == 0);
+
+	for (int i = 0; i < count; i++) {
+		uint8_t ref[HDLC_ENCODED_MAX_LEN];
+		const int ref_len = hdlc_ref_encode(&frames[i], ref, sizeof(ref));
+
+		FUZZ_CHECK(encoded_lens[i] == ref_len);
+		FUZZ_CHECK(memcmp(buffers[i], ref, ref_len) == 0);
+	}
+}
+
+//--------------------------------------------------
+static void _fuzz_encode_set_control(hdlc_frame_t *frame, const uint8_t *encoded, int encoded_len,
+				     uint8_t control)
+{
+	uint8_t live[HDLC_ENCODED_MAX_LEN];
+	uint8_t ref[HDLC_ENCODED_MAX_LEN];
+
+	memcpy(live, encoded, encoded_len);
+
+	frame->control.value = control;
+
+	const int live_len = hdlc_encoded_set_control(live, encoded_len, sizeof(live), control);
+	const int ref_len = hdlc_ref_encode(frame, ref, sizeof(ref));
+
+	FUZZ_CHECK(ref_len > 0);
+	FUZZ_CHECK(live_len == ref_len);
+	FUZZ_CHECK(memcmp(live, ref, live_len) == 0);
+}
+
+//--------------------------------------------------
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	if (size < 4) {
+		return 0;
+	}
+
+	hdlc_frame_t frame;
+	hdlc_frame_init(&frame);
+
+	const uint8_t selector = data[0];
+	const uint8_t new_control = data[1];
+
+	frame.address = data[2];
+	frame.control.value = data[3];
+	frame.info_len = (size - 4) > HDLC_INFO_MAX_LEN ? HDLC_INFO_MAX_LEN : (hdlc_info_len_t)(size - 4);
+	memcpy(frame.info, data + 4, frame.info_len);
+
+	// Mostly short buffers so running out of space is covered as well
+	const int buffer_size = (selector & 0x80) ? HDLC_ENCODED_MAX_LEN : selector;
+	_fuzz_encode_one_shot(&frame, buffer_size);
+
+	uint8_t encoded[HDLC_ENCODED_MAX_LEN];
+	const int encoded_len = hdlc_ref_encode(&frame, encoded, sizeof(encoded));
+	FUZZ_CHECK(encoded_len > 0);
+
+	_fuzz_encode_resumable(&frame, encoded, encoded_len, (selector & 0x0F) + 1);
+
+	// Both decoders must give the original frame back
+	hdlc_frame_t live_frame;
+	hdlc_frame_t ref_frame;
+	hdlc_frame_init(&live_frame);
+	hdlc_frame_init(&ref_frame);
+
+	uint8_t *copy = fuzz_dup(encoded, encoded_len);
+	if (copy != NULL) {
+		FUZZ_CHECK(hdlc_decode(&live_frame, copy, encoded_len) == 0);
+		FUZZ_CHECK(hdlc_ref_decode(&ref_frame, copy, encoded_len) == 0);
+		FUZZ_CHECK(fuzz_frames_equal(&live_frame, &frame));
+		FUZZ_CHECK(fuzz_frames_equal(&ref_frame, &frame));
+		free(copy);
+	}
+
+	_fuzz_encode_batch(&frame, (selector >> 4) % BATCH_MAX + 1);
+
+	_fuzz_encode_set_control(&frame, encoded, encoded_len, new_control);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "fuzz.h"
+#include "hdlc_private.h"
+#include "hdlc_ref.h"
+
+//--------------------------------------------------
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	uint8_t *copy = fuzz_dup(data, size);
+	if (copy == NULL) {
+		return 0;
+	}
+
+	const int len = (int)size;
+	const uint16_t expected = hdlc_ref_calculate_fcs(copy, len);
+
+	FUZZ_CHECK(_hdlc_calculate_fcs(copy, len) == expected);
+
+	// Split the input and put the FCS back together from both halves
+	const int split = len > 0 ? copy[0] % (len + 1) : 0;
+	const uint16_t head = _hdlc_calculate_fcs(copy, split);
+	const uint16_t tail = _hdlc_calculate_fcs(copy + split, len - split);
+
+	FUZZ_CHECK(hdlc_fcs_combine(head, tail, (size_t)(len - split)) == expected);
+
+	free(copy);
+
+	return 0;
+}
\ No newline at end of file
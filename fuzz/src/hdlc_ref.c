@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_ref.h"
+
+#include <string.h>
+
+#define REF_DELIMITER 0x7E
+#define REF_ESCAPE    0x7D
+#define REF_INVERTED  0x20
+
+#define REF_CRC_POLY    0x1021
+#define REF_CRC_INIT    0xFFFF
+#define REF_CRC_XOR_OUT 0xFFFF
+
+//--------------------------------------------------
+static uint8_t _hdlc_ref_reverse_bits(uint8_t byte)
+{
+	byte = (byte & 0xF0) >> 4 | (byte & 0x0F) << 4;
+	byte = (byte & 0xCC) >> 2 | (byte & 0x33) << 2;
+	byte = (byte & 0xAA) >> 1 | (byte & 0x55) << 1;
+	return byte;
+}
+
+//--------------------------------------------------
+static uint16_t _hdlc_ref_reverse_bits_16(uint16_t value)
+{
+	value = (value & 0xFF00) >> 8 | (value & 0x00FF) << 8;
+	value = (value & 0xF0F0) >> 4 | (value & 0x0F0F) << 4;
+	value = (value & 0xCCCC) >> 2 | (value & 0x3333) << 2;
+	value = (value & 0xAAAA) >> 1 | (value & 0x5555) << 1;
+	return value;
+}
+
+//--------------------------------------------------
+static int _hdlc_ref_write_byte(uint8_t byte, uint8_t *data, int len)
+{
+	if (byte == REF_DELIMITER || byte == REF_ESCAPE) {
+		if (len < 2) {
+			return -1;
+		}
+
+		data[0] = REF_ESCAPE;
+		data[1] = byte ^ REF_INVERTED;
+
+		return 2;
+	}
+
+	if (len < 1) {
+		return -1;
+	}
+
+	data[0] = byte;
+
+	return 1;
+}
+
+//--------------------------------------------------
+static int _hdlc_ref_read_byte(uint8_t *byte, const uint8_t *data, int len)
+{
+	if (data[0] == REF_ESCAPE) {
+		if (len < 2) {
+			return -1;
+		}
+
+		*byte = data[1] ^ REF_INVERTED;
+
+		return 2;
+	}
+
+	if (len < 1) {
+		return -1;
+	}
+
+	*byte = data[0];
+
+	return 1;
+}
+
+//--------------------------------------------------
+uint16_t hdlc_ref_calculate_fcs(const uint8_t *data, int len)
+{
+	uint16_t fcs = REF_CRC_INIT;
+
+	while (len-- > 0) {
+		fcs ^= (_hdlc_ref_reverse_bits(*data++) << 8);
+		for (int i = 0; i < 8; i++) {
+			if (fcs & 0x8000) {
+				fcs = (fcs << 1) ^ REF_CRC_POLY;
+			} else {
+				fcs <<= 1;
+			}
+		}
+	}
+
+	return _hdlc_ref_reverse_bits_16(fcs) ^ REF_CRC_XOR_OUT;
+}
+
+//--------------------------------------------------
+int hdlc_ref_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
+{
+	int encoded_len = 0;
+	int result = 0;
+
+	if (frame == NULL || data == NULL || len < 1) {
+		return -1;
+	}
+
+	data[encoded_len++] = REF_DELIMITER;
+
+	result = _hdlc_ref_write_byte(frame->address, data + encoded_len, len - encoded_len);
+	if (result < 1) {
+		return -1;
+	}
+
+	encoded_len += result;
+
+	result = _hdlc_ref_write_byte(frame->control.value, data + encoded_len, len - encoded_len);
+	if (result < 1) {
+		return -1;
+	}
+
+	encoded_len += result;
+
+	for (int i = 0; i < frame->info_len; i++) {
+		result = _hdlc_ref_write_byte(frame->info[i], data + encoded_len, len - encoded_len);
+		if (result < 1) {
+			return -1;
+		}
+
+		encoded_len += result;
+	}
+
+	// The FCS covers the stuffed address, control and information bytes
+	const uint16_t fcs = hdlc_ref_calculate_fcs(data + 1, encoded_len - 1);
+
+	result = _hdlc_ref_write_byte((fcs >> 8) & 0xFF, data + encoded_len, len - encoded_len);
+	if (result < 1) {
+		return -1;
+	}
+
+	encoded_len += result;
+
+	result = _hdlc_ref_write_byte(fcs & 0xFF, data + encoded_len, len - encoded_len);
+	if (result < 1) {
+		return -1;
+	}
+
+	encoded_len += result;
+
+	if (encoded_len >= len) {
+		return -1;
+	}
+
+	data[encoded_len++] = REF_DELIMITER;
+
+	return encoded_len;
+}
+
+//--------------------------------------------------
+int hdlc_ref_decode(hdlc_frame_t *frame, const uint8_t *data, int len)
+{
+	hdlc_state_t state = HDLC_STATE_IDLE;
+	int result = 0;
+
+	if (frame == NULL || data == NULL) {
+		return -1;
+	}
+
+	// Walk back from the stop flag to find where the (possibly escaped) FCS starts
+	int fcs_offset = len - 3;
+	if (len >= 6) {
+		const int fcs_low_offset = (data[len - 3] == REF_ESCAPE) ? len - 3 : len - 2;
+
+		fcs_offset = (data[fcs_low_offset - 2] == REF_ESCAPE) ? fcs_low_offset - 2
+								      : fcs_low_offset - 1;
+	}
+
+	for (int i = 0; i < len; i++) {
+		switch (state) {
+		case HDLC_STATE_IDLE:
+			if (data[i] != REF_DELIMITER) {
+				return -1;
+			}
+
+			state = HDLC_STATE_ADDRESS;
+			break;
+		case HDLC_STATE_ADDRESS:
+			result = _hdlc_ref_read_byte(&frame->address, data + i, len - i);
+			if (result < 1) {
+				return -1;
+			}
+
+			i += result - 1;
+			state = HDLC_STATE_CONTROL;
+			break;
+		case HDLC_STATE_CONTROL:
+			result = _hdlc_ref_read_byte(&frame->control.value, data + i, len - i);
+			if (result < 1) {
+				return -1;
+			}
+
+			i += result - 1;
+			state = HDLC_STATE_INFO;
+			break;
+		case HDLC_STATE_INFO:
+			if (i >= fcs_offset) {
+				i--;
+				state = HDLC_STATE_FCS;
+				break;
+			}
+
+			if (frame->info_len >= HDLC_INFO_MAX_LEN) {
+				return -1;
+			}
+
+			result = _hdlc_ref_read_byte(&frame->info[frame->info_len], data + i, len - i);
+			if (result < 1) {
+				return -1;
+			}
+
+			i += result - 1;
+			frame->info_len++;
+			break;
+		case HDLC_STATE_FCS: {
+			uint8_t fcs_high = 0;
+			uint8_t fcs_low = 0;
+
+			result = _hdlc_ref_read_byte(&fcs_high, data + i, len - i);
+			if (result < 1) {
+				return -1;
+			}
+
+			i += result;
+			if (i >= len) {
+				return -1;
+			}
+
+			result = _hdlc_ref_read_byte(&fcs_low, data + i, len - i);
+			if (result < 1) {
+				return -1;
+			}
+
+			i += result - 1;
+
+			if (hdlc_ref_calculate_fcs(data + 1, fcs_offset - 1) !=
+			    ((fcs_high << 8) | fcs_low)) {
+				return -1;
+			}
+
+			state = HDLC_STATE_STOP_FLAG;
+			break;
+		}
+		case HDLC_STATE_STOP_FLAG:
+			// Only the start flag is checked, whatever follows the FCS is accepted
+			if (data[0] == REF_DELIMITER) {
+				return 0;
+			}
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	return -1;
+}
+
+//--------------------------------------------------
+static void _hdlc_ref_deframer_restart(hdlc_ref_deframer_t *deframer)
+{
+	deframer->state = HDLC_DEFRAMER_STATE_START;
+	deframer->raw_len = 0;
+	deframer->bytes_len = 0;
+}
+
+//--------------------------------------------------
+static void _hdlc_ref_deframer_take(hdlc_ref_deframer_t *deframer, uint8_t byte, int start)
+{
+	if (deframer->bytes_len == HDLC_INFO_MAX_LEN + 4) {
+		deframer->stats.length_errors++;
+		deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+		return;
+	}
+
+	deframer->bytes[deframer->bytes_len] = byte;
+	deframer->starts[deframer->bytes_len] = start;
+	deframer->bytes_len++;
+
+	deframer->state = HDLC_DEFRAMER_STATE_DATA;
+}
+
+//--------------------------------------------------
+static void _hdlc_ref_deframer_end(hdlc_ref_deframer_t *deframer)
+{
+	const int len = deframer->bytes_len;
+
+	if (len < 4) {
+		deframer->stats.length_errors++;
+		return;
+	}
+
+	// The FCS covers everything sent before it, escapes included
+	const uint16_t fcs = (deframer->bytes[len - 2] << 8) | deframer->bytes[len - 1];
+	if (hdlc_ref_calculate_fcs(deframer->raw, deframer->starts[len - 2]) != fcs) {
+		deframer->stats.fcs_errors++;
+		return;
+	}
+
+	hdlc_frame_t frame;
+	frame.address = deframer->bytes[0];
+	frame.control.value = deframer->bytes[1];
+	frame.info_len = (hdlc_info_len_t)(len - 4);
+	memcpy(frame.info, deframer->bytes + 2, len - 4);
+
+	deframer->stats.frames++;
+
+	if (deframer->cb != NULL) {
+		const hdlc_frame_desc_t desc = {
+			.frame = &frame,
+			.encoded_len = deframer->raw_len,
+		};
+
+		deframer->cb(deframer->user, &desc);
+	}
+}
+
+//--------------------------------------------------
+void hdlc_ref_deframer_init(hdlc_ref_deframer_t *deframer, hdlc_deframer_cb_t cb, void *user)
+{
+	memset(deframer, 0, sizeof(*deframer));
+
+	deframer->cb = cb;
+	deframer->user = user;
+	deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+}
+
+//--------------------------------------------------
+void hdlc_ref_deframer_push(hdlc_ref_deframer_t *deframer, uint8_t byte)
+{
+	if (deframer->state != HDLC_DEFRAMER_STATE_HUNT) {
+		deframer->raw[deframer->raw_len++] = byte;
+	}
+
+	switch (deframer->state) {
+	case HDLC_DEFRAMER_STATE_HUNT:
+		if (byte == REF_DELIMITER) {
+			_hdlc_ref_deframer_restart(deframer);
+		}
+		break;
+	case HDLC_DEFRAMER_STATE_START:
+	case HDLC_DEFRAMER_STATE_DATA:
+		if (byte == REF_DELIMITER) {
+			if (deframer->state == HDLC_DEFRAMER_STATE_DATA) {
+				_hdlc_ref_deframer_end(deframer);
+			}
+
+			_hdlc_ref_deframer_restart(deframer);
+		} else if (byte == REF_ESCAPE) {
+			deframer->state = HDLC_DEFRAMER_STATE_ESCAPED;
+		} else {
+			_hdlc_ref_deframer_take(deframer, byte, deframer->raw_len - 1);
+		}
+		break;
+	case HDLC_DEFRAMER_STATE_ESCAPED:
+		if (byte == REF_DELIMITER) {
+			deframer->stats.aborts++;
+			_hdlc_ref_deframer_restart(deframer);
+		} else if (byte == REF_ESCAPE) {
+			deframer->stats.escape_errors++;
+			deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+		} else {
+			_hdlc_ref_deframer_take(deframer, byte ^ REF_INVERTED,
+						deframer->raw_len - 2);
+		}
+		break;
+	default:
+		break;
+	}
+}
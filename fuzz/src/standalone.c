@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "fuzz.h"
+
+// Stand-in for libFuzzer on compilers without -fsanitize=fuzzer. Replays the files given on the
+// command line, or runs random inputs biased towards flag and escape bytes when there are none.
+// HDLC_FUZZ_RUNS and HDLC_FUZZ_SEED override the number of random inputs and the seed.
+
+#define DEFAULT_RUNS 100000
+#define DEFAULT_SEED 1
+#define MAX_INPUT    1024
+
+//--------------------------------------------------
+static uint64_t next_random(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+//--------------------------------------------------
+static uint64_t env_or_default(const char *name, uint64_t value)
+{
+	const char *env = getenv(name);
+	return env != NULL ? strtoull(env, NULL, 0) : value;
+}
+
+//--------------------------------------------------
+static int run_file(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		fprintf(stderr, "Failed to open %s\n", path);
+		return -1;
+	}
+
+	uint8_t *data = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
+
+	for (;;) {
+		if (size == capacity) {
+			capacity = capacity ? capacity * 2 : 4096;
+
+			uint8_t *grown = realloc(data, capacity);
+			if (grown == NULL) {
+				free(data);
+				fclose(file);
+				return -1;
+			}
+
+			data = grown;
+		}
+
+		const size_t result = fread(data + size, 1, capacity - size, file);
+		if (result == 0) {
+			break;
+		}
+
+		size += result;
+	}
+
+	fclose(file);
+
+	LLVMFuzzerTestOneInput(data, size);
+
+	free(data);
+	return 0;
+}
+
+//--------------------------------------------------
+static void run_random(uint64_t runs, uint64_t seed)
+{
+	static const uint8_t special[] = {0x7E, 0x7D, 0x5E, 0x5D, 0x00, 0xFF};
+
+	uint8_t data[MAX_INPUT];
+
+	for (uint64_t run = 0; run < runs; run++) {
+		const size_t size = next_random(&seed) % sizeof(data);
+
+		for (size_t i = 0; i < size; i++) {
+			const uint64_t value = next_random(&seed);
+
+			// One in four bytes is one of the interesting framing values
+			if ((value & 3) == 0) {
+				data[i] = special[(value >> 8) % sizeof(special)];
+			} else {
+				data[i] = (uint8_t)(value >> 8);
+			}
+		}
+
+		LLVMFuzzerTestOneInput(data, size);
+	}
+
+	printf("%llu random inputs passed\n", (unsigned long long)runs);
+}
+
+//--------------------------------------------------
+int main(int argc, char *argv[])
+{
+	if (argc > 1) {
+		for (int i = 1; i < argc; i++) {
+			if (run_file(argv[i]) < 0) {
+				return 1;
+			}
+		}
+
+		printf("%d inputs passed\n", argc - 1);
+		return 0;
+	}
+
+	run_random(env_or_default("HDLC_FUZZ_RUNS", DEFAULT_RUNS),
+		   env_or_default("HDLC_FUZZ_SEED", DEFAULT_SEED));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <hdlc.h>
+#include <hdlc_deframer.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One decoded frame as it sits in shared memory
+typedef struct {
+	int32_t encoded_len;
+	hdlc_deframer_times_t times; // Set when the producer's deframer has a clock
+	hdlc_frame_t frame;
+} hdlc_ipc_frame_t;
+
+typedef struct {
+	int fd;
+	void *base;
+	size_t size;
+	uint32_t slots;
+	int producer;
+
+	// Producer: the deframer decodes straight into the slot of the next sequence number
+	hdlc_deframer_t deframer;
+	uint64_t next;
+
+	// Consumer: every consumer has its own cursor and sees every frame it is not lapped on
+	uint64_t cursor;
+	uint64_t lost;
+	int peeked; // Set while the frame at cursor is handed out by peek
+} hdlc_ipc_t;
+
+// A single producer broadcasts decoded frames to any number of consumers in other processes
+// through a memfd ring. The producer never waits, a consumer that falls more than a ring behind
+// skips ahead and counts the frames it lost. Consumers read frames in place and learn on
+// release whether the producer overwrote the frame meanwhile.
+int hdlc_ipc_create(hdlc_ipc_t *ipc, uint32_t slots);
+int hdlc_ipc_attach(hdlc_ipc_t *ipc, int fd);
+int hdlc_ipc_close(hdlc_ipc_t *ipc);
+
+int hdlc_ipc_push(hdlc_ipc_t *ipc, const uint8_t *data, int len);
+
+const hdlc_ipc_frame_t *hdlc_ipc_peek(hdlc_ipc_t *ipc);
+int hdlc_ipc_release(hdlc_ipc_t *ipc);
+int hdlc_ipc_wait(hdlc_ipc_t *ipc, int timeout_ms);
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "hdlc_ipc.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HDLC_IPC_MAGIC   0x49444C48 // "HLDI"
+#define HDLC_IPC_VERSION 1
+
+// Shared by every process that maps the ring. Processes may run different builds, the layout
+// fields make sure they agree on it.
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slots;
+	uint32_t slot_size;
+	_Alignas(64) atomic_uint_least64_t head; // Sequence number of the next frame to publish
+	atomic_uint futex;                       // Bumped after every push that published
+	atomic_uint waiters;
+} hdlc_ipc_header_t;
+
+// Holds sequence number + 1 once published, 0 while the producer is writing into it
+typedef struct {
+	_Alignas(64) atomic_uint_least64_t seq;
+	hdlc_ipc_frame_t desc;
+} hdlc_ipc_slot_t;
+
+//--------------------------------------------------
+static hdlc_ipc_header_t *_hdlc_ipc_header(const hdlc_ipc_t *ipc)
+{
+	return ipc->base;
+}
+
+//--------------------------------------------------
+static hdlc_ipc_slot_t *_hdlc_ipc_slot(const hdlc_ipc_t *ipc, uint64_t seq)
+{
+	hdlc_ipc_slot_t *slots = (hdlc_ipc_slot_t *)((uint8_t *)ipc->base + sizeof(hdlc_ipc_header_t));
+
+	return &slots[seq & (ipc->slots - 1)];
+}
+
+//--------------------------------------------------
+static size_t _hdlc_ipc_size(uint32_t slots)
+{
+	return sizeof(hdlc_ipc_header_t) + (size_t)slots * sizeof(hdlc_ipc_slot_t);
+}
+
+// Marks the slot of the next sequence number as being written and decodes into it
+//--------------------------------------------------
+static void _hdlc_ipc_claim(hdlc_ipc_t *ipc)
+{
+	hdlc_ipc_slot_t *slot = _hdlc_ipc_slot(ipc, ipc->next);
+
+	atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	ipc->deframer.frame = &slot->desc.frame;
+}
+
+//--------------------------------------------------
+static void _hdlc_ipc_on_frame(void *user, const hdlc_frame_desc_t *desc)
+{
+	hdlc_ipc_t *ipc = user;
+	hdlc_ipc_slot_t *slot = _hdlc_ipc_slot(ipc, ipc->next);
+
+	slot->desc.encoded_len = desc->encoded_len;
+	slot->desc.times = desc->times;
+
+	atomic_store_explicit(&slot->seq, ipc->next + 1, memory_order_release);
+	atomic_store_explicit(&_hdlc_ipc_header(ipc)->head, ++ipc->next, memory_order_release);
+
+	_hdlc_ipc_claim(ipc);
+}
+
+//--------------------------------------------------
+int hdlc_ipc_create(hdlc_ipc_t *ipc, uint32_t slots)
+{
+	if (ipc == NULL || slots < 2 || (slots & (slots - 1)) != 0) {
+		return -1;
+	}
+
+	memset(ipc, 0, sizeof(*ipc));
+
+	ipc->fd = memfd_create("hdlc_ipc", MFD_CLOEXEC);
+	if (ipc->fd < 0) {
+		return -1;
+	}
+
+	ipc->size = _hdlc_ipc_size(slots);
+
+	if (ftruncate(ipc->fd, (off_t)ipc->size) < 0) {
+		close(ipc->fd);
+		return -1;
+	}
+
+	ipc->base = mmap(NULL, ipc->size, PROT_READ | PROT_WRITE, MAP_SHARED, ipc->fd, 0);
+	if (ipc->base == MAP_FAILED) {
+		close(ipc->fd);
+		return -1;
+	}
+
+	// A fresh memfd reads as zeros, so every slot starts out unpublished
+	hdlc_ipc_header_t *header = _hdlc_ipc_header(ipc);
+	header->magic = HDLC_IPC_MAGIC;
+	header->version = HDLC_IPC_VERSION;
+	header->slots = slots;
+	header->slot_size = sizeof(hdlc_ipc_slot_t);
+
+	ipc->slots = slots;
+	ipc->producer = 1;
+
+	if (hdlc_deframer_init(&ipc->deframer, &_hdlc_ipc_slot(ipc, 0)->desc.frame,
+			       _hdlc_ipc_on_frame, ipc) < 0) {
+		hdlc_ipc_close(ipc);
+		return -1;
+	}
+
+	_hdlc_ipc_claim(ipc);
+
+	return 0;
+}
+
+// Maps a ring created by another process, which handed its fd over. Takes ownership of the fd,
+// which is closed again when attaching fails. The first frame read is the first one published
+// after this call.
+//--------------------------------------------------
+int hdlc_ipc_attach(hdlc_ipc_t *ipc, int fd)
+{
+	if (fd < 0) {
+		return -1;
+	}
+
+	if (ipc == NULL) {
+		close(fd);
+		return -1;
+	}
+
+	memset(ipc, 0, sizeof(*ipc));
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(hdlc_ipc_header_t)) {
+		close(fd);
+		return -1;
+	}
+
+	void *base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		close(fd);
+		return -1;
+	}
+
+	const hdlc_ipc_header_t *header = base;
+
+	if (header->magic != HDLC_IPC_MAGIC || header->version != HDLC_IPC_VERSION ||
+	    header->slot_size != sizeof(hdlc_ipc_slot_t) || header->slots < 2 ||
+	    (header->slots & (header->slots - 1)) != 0 ||
+	    _hdlc_ipc_size(header->slots) != (size_t)st.st_size) {
+		munmap(base, st.st_size);
+		close(fd);
+		return -1;
+	}
+
+	ipc->fd = fd;
+	ipc->base = base;
+	ipc->size = st.st_size;
+	ipc->slots = header->slots;
+	ipc->cursor = atomic_load_explicit(&_hdlc_ipc_header(ipc)->head, memory_order_acquire);
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_ipc_close(hdlc_ipc_t *ipc)
+{
+	if (ipc == NULL || ipc->base == NULL) {
+		return -1;
+	}
+
+	munmap(ipc->base, ipc->size);
+	close(ipc->fd);
+
+	ipc->base = NULL;
+	ipc->fd = -1;
+
+	return 0;
+}
+
+// Decodes bytes from the line into the ring and wakes the consumers once for all the frames
+// found in them. Returns the number of frames published.
+//--------------------------------------------------
+int hdlc_ipc_push(hdlc_ipc_t *ipc, const uint8_t *data, int len)
+{
+	if (ipc == NULL || ipc->base == NULL || !ipc->producer) {
+		return -1;
+	}
+
+	const int frames = hdlc_deframer_push(&ipc->deframer, data, len);
+	if (frames <= 0) {
+		return frames;
+	}
+
+	hdlc_ipc_header_t *header = _hdlc_ipc_header(ipc);
+
+	atomic_fetch_add(&header->futex, 1);
+
+	if (atomic_load(&header->waiters) > 0) {
+		syscall(SYS_futex, &header->futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+	}
+
+	return frames;
+}
+
+// The next frame in place, NULL when there is none. The slot the producer writes into next is
+// never handed out, so a consumer can be at most one ring less one frame behind.
+//--------------------------------------------------
+const hdlc_ipc_frame_t *hdlc_ipc_peek(hdlc_ipc_t *ipc)
+{
+	if (ipc == NULL || ipc->base == NULL || ipc->producer) {
+		return NULL;
+	}
+
+	for (;;) {
+		const uint64_t head =
+			atomic_load_explicit(&_hdlc_ipc_header(ipc)->head, memory_order_acquire);
+
+		if (ipc->cursor == head) {
+			return NULL;
+		}
+
+		if (head - ipc->cursor >= ipc->slots) {
+			ipc->lost += head - (ipc->slots - 1) - ipc->cursor;
+			ipc->cursor = head - (ipc->slots - 1);
+		}
+
+		hdlc_ipc_slot_t *slot = _hdlc_ipc_slot(ipc, ipc->cursor);
+
+		if (atomic_load_explicit(&slot->seq, memory_order_acquire) == ipc->cursor + 1) {
+			ipc->peeked = 1;
+			return &slot->desc;
+		}
+
+		// Overwritten since head was read
+		ipc->lost++;
+		ipc->cursor++;
+	}
+}
+
+// Moves past the frame from peek. Returns -1 when the producer started overwriting it while it
+// was being read, in which case whatever was read from it must be discarded, and without moving
+// when peek did not hand out a frame.
+//--------------------------------------------------
+int hdlc_ipc_release(hdlc_ipc_t *ipc)
+{
+	if (ipc == NULL || ipc->base == NULL || ipc->producer || !ipc->peeked) {
+		return -1;
+	}
+
+	ipc->peeked = 0;
+
+	hdlc_ipc_slot_t *slot = _hdlc_ipc_slot(ipc, ipc->cursor);
+
+	atomic_thread_fence(memory_order_acquire);
+
+	const int intact =
+		atomic_load_explicit(&slot->seq, memory_order_relaxed) == ipc->cursor + 1;
+
+	ipc->cursor++;
+
+	if (!intact) {
+		ipc->lost++;
+		return -1;
+	}
+
+	return 0;
+}
+
+// Sleeps until a frame is published or the timeout passes, a negative timeout waits forever.
+// Returns 1 when there are frames to read and 0 when there are none.
+//--------------------------------------------------
+int hdlc_ipc_wait(hdlc_ipc_t *ipc, int timeout_ms)
+{
+	if (ipc == NULL || ipc->base == NULL || ipc->producer) {
+		return -1;
+	}
+
+	hdlc_ipc_header_t *header = _hdlc_ipc_header(ipc);
+
+	// A push after seen was read changes the futex word and the wait returns right away
+	const unsigned seen = atomic_load(&header->futex);
+
+	if (atomic_load(&header->head) != ipc->cursor) {
+		return 1;
+	}
+
+	struct timespec timeout = {
+		.tv_sec = timeout_ms / 1000,
+		.tv_nsec = (long)(timeout_ms % 1000) * 1000000,
+	};
+
+	atomic_fetch_add(&header->waiters, 1);
+
+	const long result = syscall(SYS_futex, &header->futex, FUTEX_WAIT, seen,
+				    timeout_ms < 0 ? NULL : &timeout, NULL, 0);
+	const int error = errno;
+
+	atomic_fetch_sub(&header->waiters, 1);
+
+	if (result < 0 && error != EAGAIN && error != EINTR && error != ETIMEDOUT) {
+		return -1;
+	}
+
+	return atomic_load(&header->head) != ipc->cursor;
+}
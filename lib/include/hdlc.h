@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "hdlc_export.h"
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -17,6 +19,12 @@
 #error "HDLC_INFO_MAX_LEN must be less than or equal to 255"
 #endif
 
+// Worst case encoded size: flags plus every address, control, info and FCS byte escaped
+#define HDLC_ENCODED_MAX_LEN (2 * (HDLC_INFO_MAX_LEN + 4) + 2)
+
+// Length of the sequence that aborts a partially transmitted frame
+#define HDLC_ABORT_LEN 2
+
 typedef uint8_t hdlc_address_t;
 typedef uint8_t hdlc_info_t[HDLC_INFO_MAX_LEN];
 typedef uint8_t hdlc_info_len_t;
@@ -79,12 +87,49 @@ typedef struct {
 	hdlc_info_len_t info_len;
 } __attribute__((packed)) hdlc_frame_t;
 
-int hdlc_frame_init(hdlc_frame_t *frame);
+// Monotonic time in a unit of the caller's choice, e.g. nanoseconds of CLOCK_MONOTONIC
+typedef uint64_t (*hdlc_clock_t)(void *user);
+
+// Taken while a frame is pulled when the encoder has a clock, zero otherwise
+typedef struct {
+	uint64_t first_byte; // Opening flag pulled
+	uint64_t fcs;        // FCS complete, the trailer goes out next
+	uint64_t flag;       // Closing flag pulled
+} hdlc_encoder_times_t;
+
+typedef struct {
+	const hdlc_frame_t *frame;
+	hdlc_state_t state;
+	uint16_t fcs;
+	uint8_t index;
+	uint8_t pending;
+	uint8_t has_pending;
+	hdlc_clock_t clock;
+	void *clock_user;
+	hdlc_encoder_times_t times;
+} hdlc_encoder_t;
+
+HDLC_API int hdlc_frame_init(hdlc_frame_t *frame);
+
+HDLC_API void hdlc_i_frame_control_init(hdlc_control_t *control, uint8_t ns, uint8_t pf,
+					uint8_t nr);
+HDLC_API void hdlc_s_frame_control_init(hdlc_control_t *control, hdlc_control_s_frame_code_t s,
+					uint8_t pf, uint8_t nr);
+HDLC_API int hdlc_u_frame_control_init(hdlc_control_t *control, hdlc_control_u_frame_code_t m,
+				       uint8_t pf);
+
+HDLC_API int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len);
+HDLC_API int hdlc_encode_batch(const hdlc_frame_t *frames, int count, uint8_t *const *data,
+			       const int *len, int *encoded_lens);
+HDLC_API int hdlc_encode_abort(uint8_t *data, int len);
+HDLC_API int hdlc_encoded_set_control(uint8_t *data, int len, int size, uint8_t control);
 
-void hdlc_i_frame_control_init(hdlc_control_t *control, uint8_t ns, uint8_t pf, uint8_t nr);
-void hdlc_s_frame_control_init(hdlc_control_t *control, hdlc_control_s_frame_code_t s, uint8_t pf,
-			       uint8_t nr);
-int hdlc_u_frame_control_init(hdlc_control_t *control, hdlc_control_u_frame_code_t m, uint8_t pf);
+HDLC_API int hdlc_encoder_init(hdlc_encoder_t *encoder, const hdlc_frame_t *frame);
+HDLC_API int hdlc_encoder_set_clock(hdlc_encoder_t *encoder, hdlc_clock_t clock, void *user);
+HDLC_API int hdlc_encoder_pull(hdlc_encoder_t *encoder, uint8_t *data, int len);
+HDLC_API int hdlc_encoder_done(const hdlc_encoder_t *encoder);
+HDLC_API int hdlc_encoder_started(const hdlc_encoder_t *encoder);
+HDLC_API int hdlc_encoder_remaining(const hdlc_encoder_t *encoder);
+HDLC_API int hdlc_encoder_abort(hdlc_encoder_t *encoder, uint8_t *data, int len);
 
-int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len);
-int hdlc_decode(hdlc_frame_t *frame, uint8_t *data, int len);
\ No newline at end of file
+HDLC_API int hdlc_decode(hdlc_frame_t *frame, uint8_t *data, int len);
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc.h"
+
+typedef enum {
+	HDLC_DEFRAMER_STATE_HUNT,    // Discarding bytes until the next flag
+	HDLC_DEFRAMER_STATE_START,   // Flag seen, no frame bytes yet
+	HDLC_DEFRAMER_STATE_DATA,    // Inside a frame
+	HDLC_DEFRAMER_STATE_ESCAPED, // Inside a frame, previous byte was an escape
+	HDLC_DEFRAMER_STATE_COUNT,
+} hdlc_deframer_state_t;
+
+// Taken along the way when the deframer has a clock, zero otherwise
+typedef struct {
+	uint64_t first_byte; // First byte after the opening flag taken in
+	uint64_t flag;       // Closing flag detected
+	uint64_t fcs;        // FCS verified
+	uint64_t delivered;  // Right before the callback
+} hdlc_deframer_times_t;
+
+typedef struct {
+	const hdlc_frame_t *frame;
+	int encoded_len; // Bytes on the line after the opening flag, closing flag included
+	hdlc_deframer_times_t times;
+} hdlc_frame_desc_t;
+
+typedef struct {
+	uint32_t frames;
+	uint32_t fcs_errors;
+	uint32_t aborts;        // Frames ended by an escape followed by a flag
+	uint32_t escape_errors; // Escape followed by another escape
+	uint32_t length_errors; // Frames too short for an FCS or too long for the information field
+} hdlc_deframer_stats_t;
+
+typedef void (*hdlc_deframer_cb_t)(void *user, const hdlc_frame_desc_t *desc);
+
+typedef struct {
+	hdlc_frame_t *frame;
+	hdlc_deframer_cb_t cb;
+	void *user;
+	hdlc_clock_t clock;
+	void *clock_user;
+	uint64_t first_byte; // Time the current frame started, when there is a clock
+	hdlc_deframer_stats_t stats;
+	hdlc_deframer_state_t state;
+	uint16_t fcs;
+	int count;       // Bytes of the current frame taken out of the delay line
+	int encoded_len; // Bytes of the current frame seen on the line
+	int info_offset; // Information bytes already in the frame, new ones go after them
+	uint8_t delay[2]; // The last two unstuffed bytes, which are the FCS once the frame ends
+	uint8_t delay_escaped;
+	uint8_t delay_len;
+} hdlc_deframer_t;
+
+HDLC_API int hdlc_deframer_init(hdlc_deframer_t *deframer, hdlc_frame_t *frame,
+				hdlc_deframer_cb_t cb, void *user);
+HDLC_API int hdlc_deframer_set_clock(hdlc_deframer_t *deframer, hdlc_clock_t clock,
+				     void *user);
+HDLC_API int hdlc_deframer_reset(hdlc_deframer_t *deframer);
+HDLC_API int hdlc_deframer_push(hdlc_deframer_t *deframer, const uint8_t *data, int len);
\ No newline at end of file
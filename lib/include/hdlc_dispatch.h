@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_export.h"
+
+// Sets of codec kernels, in order of preference. The best one the CPU supports is bound the first
+// time a kernel is needed, HDLC_KERNELS=<name> in the environment picks another one instead.
+typedef enum {
+	HDLC_KERNELS_SCALAR,       // Table driven and word at a time, runs everywhere
+	HDLC_KERNELS_AVX512_VBMI2, // x86-64 with AVX-512 BW and VBMI2
+	HDLC_KERNELS_COUNT,
+} hdlc_kernels_id_t;
+
+HDLC_API int hdlc_dispatch_supported(hdlc_kernels_id_t id);
+HDLC_API int hdlc_dispatch_select(hdlc_kernels_id_t id);
+HDLC_API hdlc_kernels_id_t hdlc_dispatch_active(void);
+HDLC_API const char *hdlc_dispatch_name(hdlc_kernels_id_t id);
\ No newline at end of file
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Marks the public API. The shared library hides every other symbol, so calls between its own
+// functions stay direct and need no relocation at load time.
+#if defined(__GNUC__) || defined(__clang__)
+#define HDLC_API __attribute__((visibility("default")))
+#else
+#define HDLC_API
+#endif
\ No newline at end of file
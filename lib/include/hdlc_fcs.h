@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_export.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// FCS over len bytes, as hdlc_encode computes it over the stuffed bytes between the flags
+HDLC_API int hdlc_fcs_calculate(const uint8_t *data, int len, uint16_t *fcs);
+
+// FCS of A followed by B from the FCS of A, the FCS of B and the length of B, so chunks can be
+// checksummed apart and merged without reading them again
+HDLC_API uint16_t hdlc_fcs_combine(uint16_t fcs_a, uint16_t fcs_b, size_t len_b);
\ No newline at end of file
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_export.h"
+
+#include <stdint.h>
+
+#define HDLC_LOG_VALUES 4
+
+// One recorded error. The format is the literal of the reporting site and doubles as its code,
+// the values are its %s and %d arguments in order, strings by pointer. Those strings are literals
+// as well, so they are still valid whenever the event is drained.
+typedef struct {
+	const char *fmt;
+	uint64_t values[HDLC_LOG_VALUES];
+	uint8_t count;
+} hdlc_log_event_t;
+
+typedef void (*hdlc_log_cb_t)(void *user, const hdlc_log_event_t *event);
+
+// Errors are recorded into a ring owned by the reporting thread and only formatted when drained.
+// Drain from one thread at a time, threads that stop reporting hand their ring back with release.
+// Draining gives -1 when the library was built without HDLC_LOG_ENABLED.
+//
+// A ring is never taken back from a thread that exits without calling release. Once
+// HDLC_LOG_THREADS such threads have reported, there is no ring left for new threads and all of
+// their events are dropped.
+HDLC_API int hdlc_log_drain(hdlc_log_cb_t cb, void *user);
+HDLC_API int hdlc_log_format(const hdlc_log_event_t *event, char *buf, int len);
+HDLC_API uint32_t hdlc_log_dropped(void);
+HDLC_API void hdlc_log_release(void);
\ No newline at end of file
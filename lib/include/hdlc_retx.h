@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc.h"
+
+// One slot per send sequence number N(S)
+#define HDLC_RETX_STORE_SLOTS 8
+
+typedef struct {
+	uint8_t data[HDLC_ENCODED_MAX_LEN];
+	int len;
+	int tail_len;
+	uint8_t control;
+	uint8_t valid;
+} hdlc_retx_entry_t;
+
+typedef struct {
+	hdlc_retx_entry_t entries[HDLC_RETX_STORE_SLOTS];
+} hdlc_retx_store_t;
+
+HDLC_API int hdlc_retx_store_init(hdlc_retx_store_t *store);
+HDLC_API int hdlc_retx_store_put(hdlc_retx_store_t *store, const hdlc_frame_t *frame);
+HDLC_API int hdlc_retx_store_get(hdlc_retx_store_t *store, uint8_t ns,
+				 const hdlc_control_t *control, uint8_t *data, int len);
+HDLC_API int hdlc_retx_store_release(hdlc_retx_store_t *store, uint8_t ns);
+HDLC_API int hdlc_retx_store_contains(const hdlc_retx_store_t *store, uint8_t ns);
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_timer.h"
+
+#include <stdint.h>
+
+// Modulo 8 sequence numbers
+#define HDLC_RTT_SEQUENCE_COUNT 8
+
+typedef struct {
+	hdlc_tick_t sent_at[HDLC_RTT_SEQUENCE_COUNT];
+	uint8_t outstanding;   // N(S) bitmask waiting for acknowledgement
+	uint8_t retransmitted; // N(S) bitmask excluded from sampling (Karn)
+	uint8_t has_sample;
+	uint8_t backoff;
+	uint32_t srtt;   // Smoothed RTT scaled by 8
+	uint32_t rttvar; // RTT variation scaled by 4
+	hdlc_tick_t rto;
+	hdlc_tick_t min_rto;
+	hdlc_tick_t max_rto;
+} hdlc_rtt_t;
+
+HDLC_API int hdlc_rtt_init(hdlc_rtt_t *rtt, hdlc_tick_t initial_rto, hdlc_tick_t min_rto,
+			   hdlc_tick_t max_rto);
+HDLC_API int hdlc_rtt_on_send(hdlc_rtt_t *rtt, uint8_t ns, hdlc_tick_t now);
+HDLC_API int hdlc_rtt_on_ack(hdlc_rtt_t *rtt, uint8_t nr, hdlc_tick_t now);
+HDLC_API int hdlc_rtt_on_timeout(hdlc_rtt_t *rtt);
+HDLC_API int hdlc_rtt_sample(hdlc_rtt_t *rtt, hdlc_tick_t sample);
+HDLC_API hdlc_tick_t hdlc_rtt_rto(const hdlc_rtt_t *rtt);
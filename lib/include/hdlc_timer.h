@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_export.h"
+
+#include <stdint.h>
+
+#ifndef HDLC_TIMER_WHEEL_LEVELS
+#define HDLC_TIMER_WHEEL_LEVELS 4
+#endif
+
+#define HDLC_TIMER_WHEEL_BITS  6
+#define HDLC_TIMER_WHEEL_SLOTS (1 << HDLC_TIMER_WHEEL_BITS)
+
+#if HDLC_TIMER_WHEEL_LEVELS < 1 || HDLC_TIMER_WHEEL_LEVELS > 5
+#error "HDLC_TIMER_WHEEL_LEVELS must be between 1 and 5"
+#endif
+
+// Longest timeout the wheel can hold, longer timeouts are clamped
+#define HDLC_TIMER_MAX_TIMEOUT                                                                     \
+	((hdlc_tick_t)(((uint64_t)1 << (HDLC_TIMER_WHEEL_BITS * HDLC_TIMER_WHEEL_LEVELS)) - 1))
+
+typedef uint32_t hdlc_tick_t;
+
+struct hdlc_timer;
+
+typedef void (*hdlc_timer_cb_t)(void *user, struct hdlc_timer *timer);
+
+// One per running timer, e.g. T1 (retransmission), T2 (ack delay) and T3 (idle) of a link
+typedef struct hdlc_timer {
+	struct hdlc_timer *next;
+	struct hdlc_timer **pprev;
+	hdlc_tick_t expires;
+	hdlc_timer_cb_t cb;
+	void *user;
+} hdlc_timer_t;
+
+typedef struct {
+	hdlc_timer_t *slots[HDLC_TIMER_WHEEL_LEVELS][HDLC_TIMER_WHEEL_SLOTS];
+	hdlc_tick_t tick;
+	int active;
+} hdlc_timer_wheel_t;
+
+HDLC_API int hdlc_timer_wheel_init(hdlc_timer_wheel_t *wheel, hdlc_tick_t now);
+HDLC_API int hdlc_timer_wheel_advance(hdlc_timer_wheel_t *wheel, hdlc_tick_t now);
+
+HDLC_API int hdlc_timer_init(hdlc_timer_t *timer, hdlc_timer_cb_t cb, void *user);
+HDLC_API int hdlc_timer_start(hdlc_timer_wheel_t *wheel, hdlc_timer_t *timer, hdlc_tick_t timeout);
+HDLC_API int hdlc_timer_cancel(hdlc_timer_wheel_t *wheel, hdlc_timer_t *timer);
+HDLC_API int hdlc_timer_active(const hdlc_timer_t *timer);
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc.h"
+#include "hdlc_tx_sched.h"
+
+// A weighted frame with fewer bytes than this left to send is finished instead of aborted
+#ifndef HDLC_TX_PREEMPT_MIN_REMAINING
+#define HDLC_TX_PREEMPT_MIN_REMAINING 8
+#endif
+
+typedef void (*hdlc_tx_sent_cb_t)(void *user, hdlc_tx_item_t *item);
+
+typedef struct {
+	hdlc_tx_sched_t *sched;
+	hdlc_tx_sent_cb_t sent_cb;
+	void *user;
+	hdlc_tx_item_t *current;
+	hdlc_encoder_t encoder;
+	hdlc_clock_t clock;
+	void *clock_user;
+	uint32_t aborts;
+} hdlc_tx_t;
+
+HDLC_API int hdlc_tx_init(hdlc_tx_t *tx, hdlc_tx_sched_t *sched, hdlc_tx_sent_cb_t sent_cb,
+			  void *user);
+HDLC_API int hdlc_tx_set_clock(hdlc_tx_t *tx, hdlc_clock_t clock, void *user);
+HDLC_API int hdlc_tx_pull(hdlc_tx_t *tx, uint8_t *data, int len);
+HDLC_API int hdlc_tx_busy(const hdlc_tx_t *tx);
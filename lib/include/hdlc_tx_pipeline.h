@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc_export.h"
+
+#include <stdint.h>
+
+#ifndef HDLC_TX_PIPELINE_MAX_BUFFERS
+#define HDLC_TX_PIPELINE_MAX_BUFFERS 4
+#endif
+
+#ifndef HDLC_TX_PIPELINE_ALIGN
+#define HDLC_TX_PIPELINE_ALIGN 32
+#endif
+
+#if HDLC_TX_PIPELINE_MAX_BUFFERS < 2 || HDLC_TX_PIPELINE_MAX_BUFFERS > 0xFF
+#error "HDLC_TX_PIPELINE_MAX_BUFFERS must be between 2 and 255"
+#endif
+
+// Declares pipeline storage with every buffer on an HDLC_TX_PIPELINE_ALIGN boundary
+#define HDLC_TX_PIPELINE_STORAGE(name, buffer_size, buffer_count)                                  \
+	uint8_t name[(buffer_count) * (buffer_size)] __attribute__((aligned(HDLC_TX_PIPELINE_ALIGN)))
+
+// Produces encoded bytes, returns the number of bytes written or 0 when there is nothing to send
+typedef int (*hdlc_tx_pipeline_source_t)(void *user, uint8_t *data, int len);
+
+// Starts the transfer of a buffer (DMA, write()), hdlc_tx_pipeline_complete() reports its end
+typedef int (*hdlc_tx_pipeline_start_t)(void *user, const uint8_t *data, int len);
+
+typedef struct {
+	uint8_t *buffers[HDLC_TX_PIPELINE_MAX_BUFFERS];
+	int lens[HDLC_TX_PIPELINE_MAX_BUFFERS];
+	int size;
+	uint8_t count;
+	hdlc_tx_pipeline_source_t source;
+	hdlc_tx_pipeline_start_t start;
+	void *user;
+	uint8_t fill;      // Written by hdlc_tx_pipeline_service() only
+	uint8_t send;      // Written by whoever holds in_flight only
+	uint8_t ready;     // Atomic, closed buffers not completed yet
+	uint8_t in_flight; // Atomic, claimed with a compare-and-swap before a transfer starts
+} hdlc_tx_pipeline_t;
+
+// hdlc_tx_pipeline_service() and hdlc_tx_pipeline_complete() may run in different contexts, e.g. a
+// thread and the DMA interrupt, but each of them only in one at a time
+
+HDLC_API int hdlc_tx_pipeline_init(hdlc_tx_pipeline_t *pipeline, uint8_t *storage, int buffer_size,
+				   uint8_t buffer_count, hdlc_tx_pipeline_source_t source,
+				   hdlc_tx_pipeline_start_t start, void *user);
+HDLC_API int hdlc_tx_pipeline_service(hdlc_tx_pipeline_t *pipeline);
+HDLC_API int hdlc_tx_pipeline_complete(hdlc_tx_pipeline_t *pipeline);
+HDLC_API int hdlc_tx_pipeline_idle(const hdlc_tx_pipeline_t *pipeline);
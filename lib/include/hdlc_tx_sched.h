@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc.h"
+
+#ifndef HDLC_TX_SCHED_CLASS_COUNT
+#define HDLC_TX_SCHED_CLASS_COUNT 4
+#endif
+
+// Bytes credited to a weighted class per unit of weight and round
+#ifndef HDLC_TX_SCHED_QUANTUM
+#define HDLC_TX_SCHED_QUANTUM (HDLC_INFO_MAX_LEN + 4)
+#endif
+
+#if HDLC_TX_SCHED_CLASS_COUNT < 1 || HDLC_TX_SCHED_CLASS_COUNT > 0xFF
+#error "HDLC_TX_SCHED_CLASS_COUNT must be between 1 and 255"
+#endif
+
+typedef enum {
+	HDLC_TX_CLASS_STRICT,   // Served before any weighted class, lowest class id first
+	HDLC_TX_CLASS_WEIGHTED, // Shares the remaining link by weight (deficit round robin)
+} hdlc_tx_class_mode_t;
+
+typedef struct {
+	hdlc_tx_class_mode_t mode;
+	uint8_t weight; // Ignored for strict classes, must be > 0 for weighted classes
+} hdlc_tx_class_config_t;
+
+typedef struct hdlc_tx_item {
+	struct hdlc_tx_item *next;
+	const hdlc_frame_t *frame;
+	uint8_t class_id;
+} hdlc_tx_item_t;
+
+typedef struct {
+	hdlc_tx_item_t *head;
+	hdlc_tx_item_t *tail;
+	hdlc_tx_class_mode_t mode;
+	uint32_t quantum;
+	uint32_t deficit;
+	uint8_t credited;
+} hdlc_tx_class_t;
+
+typedef struct {
+	hdlc_tx_class_t classes[HDLC_TX_SCHED_CLASS_COUNT];
+	uint8_t class_count;
+	uint8_t current;
+	int pending;
+} hdlc_tx_sched_t;
+
+HDLC_API int hdlc_tx_sched_init(hdlc_tx_sched_t *sched, const hdlc_tx_class_config_t *config,
+				uint8_t class_count);
+
+HDLC_API int hdlc_tx_sched_enqueue(hdlc_tx_sched_t *sched, hdlc_tx_item_t *item,
+				   const hdlc_frame_t *frame, uint8_t class_id);
+HDLC_API int hdlc_tx_sched_requeue(hdlc_tx_sched_t *sched, hdlc_tx_item_t *item);
+HDLC_API hdlc_tx_item_t *hdlc_tx_sched_dequeue(hdlc_tx_sched_t *sched);
+HDLC_API int hdlc_tx_sched_pending(const hdlc_tx_sched_t *sched);
+HDLC_API int hdlc_tx_sched_strict_pending(const hdlc_tx_sched_t *sched);
+
+HDLC_API int hdlc_tx_sched_encode(hdlc_tx_sched_t *sched, uint8_t *data, int len);
@@ -0,0 +1,88 @@
+# Prints the footprint of each object in a static library, grouped the way a linker map is read:
+# code, read only data (flash) and initialised or zeroed data (RAM).
+#
+#   cmake -DSIZE_TOOL=<size> -DARCHIVE=<libhdlc.a> -DPROFILE=<name> -P size.cmake
+
+# Set column width
+set(COLUMN_WIDTH 10)
+
+# Pads a value to the column width, names go left and numbers right
+function(pad OUTPUT VALUE WIDTH LEFT)
+    string(LENGTH "${VALUE}" LENGTH)
+    math(EXPR MISSING "${WIDTH} - ${LENGTH}")
+
+    set(PADDING "")
+    if(MISSING GREATER 0)
+        string(REPEAT " " ${MISSING} PADDING)
+    endif()
+
+    if(LEFT)
+        set(${OUTPUT} "${VALUE}${PADDING}" PARENT_SCOPE)
+    else()
+        set(${OUTPUT} "${PADDING}${VALUE}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(print_row NAME TEXT RODATA DATA BSS)
+    pad(NAME "${NAME}" 28 TRUE)
+    set(ROW "${NAME}")
+
+    foreach(VALUE ${TEXT} ${RODATA} ${DATA} ${BSS})
+        pad(VALUE "${VALUE}" ${COLUMN_WIDTH} FALSE)
+        string(APPEND ROW "${VALUE}")
+    endforeach()
+
+    message("${ROW}")
+endfunction()
+
+execute_process(COMMAND ${SIZE_TOOL} -A ${ARCHIVE} OUTPUT_VARIABLE OUTPUT RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "${SIZE_TOOL} failed on ${ARCHIVE}")
+endif()
+
+string(REPLACE "\n" ";" LINES "${OUTPUT}")
+
+message("Profile ${PROFILE}")
+print_row("object" ".text" ".rodata" ".data" ".bss")
+
+set(OBJECT "")
+foreach(KIND TEXT RODATA DATA BSS)
+    set(TOTAL_${KIND} 0)
+endforeach()
+
+# An object header, its sections, and an empty line or the next header to finish it
+foreach(LINE ${LINES} "")
+    if(LINE MATCHES "^([^ ]+) +\\(ex " OR LINE STREQUAL "")
+        if(NOT OBJECT STREQUAL "")
+            print_row(${OBJECT} ${TEXT} ${RODATA} ${DATA} ${BSS})
+            set(OBJECT "")
+        endif()
+
+        if(LINE MATCHES "^([^ ]+) +\\(ex ")
+            string(REGEX REPLACE "\\.c\\.o$" "" OBJECT "${CMAKE_MATCH_1}")
+            foreach(KIND TEXT RODATA DATA BSS)
+                set(${KIND} 0)
+            endforeach()
+        endif()
+    elseif(LINE MATCHES "^(\\.[^ ]+) +([0-9]+)")
+        set(SECTION ${CMAKE_MATCH_1})
+        set(BYTES ${CMAKE_MATCH_2})
+
+        if(SECTION MATCHES "^\\.text")
+            set(KIND TEXT)
+        elseif(SECTION MATCHES "^\\.rodata" OR SECTION MATCHES "^\\.data\\.rel\\.ro")
+            set(KIND RODATA)
+        elseif(SECTION MATCHES "^\\.data")
+            set(KIND DATA)
+        elseif(SECTION MATCHES "^\\.bss")
+            set(KIND BSS)
+        else()
+            continue()
+        endif()
+
+        math(EXPR ${KIND} "${${KIND}} + ${BYTES}")
+        math(EXPR TOTAL_${KIND} "${TOTAL_${KIND}} + ${BYTES}")
+    endif()
+endforeach()
+
+print_row("total" ${TOTAL_TEXT} ${TOTAL_RODATA} ${TOTAL_DATA} ${TOTAL_BSS})
@@ -4,32 +4,10 @@
  * SPDX-License-Identifier: MIT
  */
 
-#include "hdlc.h"
+#include "hdlc_private.h"
 
 #include <string.h>
 
-//--------------------------------------------------
-#ifdef HDLC_LOG_ENABLED
-#include <stdio.h>
-#define ERR(...) fprintf(stderr, __VA_ARGS__)
-#else
-#define ERR(...)
-#endif
-
-//--------------------------------------------------
-#define HDLC_DELIMITER 0x7E
-#define HDLC_ESCAPE    0x7D
-#define HDLC_INVERTED  0x20
-
-//--------------------------------------------------
-#define CRC_POLY    0x1021
-#define CRC_INIT    0xFFFF
-#define CRC_XOR_OUT 0xFFFF
-
-//--------------------------------------------------
-#define LOW_BYTE(x)  ((x) & 0xFF)
-#define HIGH_BYTE(x) (((x) >> 8) & 0xFF)
-
 //--------------------------------------------------
 static int _hdlc_write_byte(uint8_t byte, uint8_t *data, int len)
 {
@@ -59,8 +37,8 @@ static int _hdlc_write_byte(uint8_t byte, uint8_t *data, int len)
 static int _hdlc_read_byte(uint8_t *byte, uint8_t *data, int len)
 {
 	if (*data == HDLC_ESCAPE) {
-		if (len < 1) {
-			ERR("[%s:%d] len < 1\n", __func__, __LINE__);
+		if (len < 2) {
+			ERR("[%s:%d] len < 2\n", __func__, __LINE__);
 			return -1;
 		}
 
@@ -79,44 +57,86 @@ static int _hdlc_read_byte(uint8_t *byte, uint8_t *data, int len)
 	}
 }
 
+// Rewrites the control byte of an encoded frame and updates its FCS without reading the tail_len
+// stuffed bytes between the control field and the FCS. Returns the new encoded length.
 //--------------------------------------------------
-static uint8_t _reverse_bits(uint8_t byte)
+int _hdlc_patch_control(uint8_t *data, int len, int size, int tail_len, uint8_t control)
 {
-	byte = (byte & 0xF0) >> 4 | (byte & 0x0F) << 4;
-	byte = (byte & 0xCC) >> 2 | (byte & 0x33) << 2;
-	byte = (byte & 0xAA) >> 1 | (byte & 0x55) << 1;
-	return byte;
-}
+	uint8_t prefix[4] = {0};
+	uint8_t fcs_high = 0;
+	uint8_t fcs_low = 0;
 
-//--------------------------------------------------
-static uint16_t _reverse_bits_16(uint16_t value)
-{
-	value = (value & 0xFF00) >> 8 | (value & 0x00FF) << 8;
-	value = (value & 0xF0F0) >> 4 | (value & 0x0F0F) << 4;
-	value = (value & 0xCCCC) >> 2 | (value & 0x3333) << 2;
-	value = (value & 0xAAAA) >> 1 | (value & 0x5555) << 1;
-	return value;
-}
+	int result = 0;
 
-// CRC-16/ISO-HDLC: x^16 + x^12 + x^5 + 1 (0x1021)
-//--------------------------------------------------
-static uint16_t _hdlc_calculate_fcs(uint8_t *data, int len)
-{
-	uint16_t fcs = CRC_INIT;
+	if (len < 6 || tail_len < 0) {
+		ERR("[%s:%d] Invalid frame\n", __func__, __LINE__);
+		return -1;
+	}
 
-	while (len--) {
-		fcs ^= (_reverse_bits(*data++) << 8);
-		for (int i = 0; i < 8; i++) {
-			if (fcs & 0x8000) {
-				fcs = (fcs << 1) ^ CRC_POLY;
-			} else {
-				fcs <<= 1;
-			}
-		}
+	const int address_len = (data[1] == HDLC_ESCAPE) ? 2 : 1;
+	const int control_offset = 1 + address_len;
+	const int old_control_len = (data[control_offset] == HDLC_ESCAPE) ? 2 : 1;
+	const int tail_offset = control_offset + old_control_len;
+	const int fcs_offset = tail_offset + tail_len;
+
+	if (fcs_offset + 3 > len) {
+		ERR("[%s:%d] fcs_offset + 3 > len\n", __func__, __LINE__);
+		return -1;
+	}
+
+	result = _hdlc_read_byte(&fcs_high, data + fcs_offset, len - fcs_offset);
+	if (result < 1 || fcs_offset + result >= len) {
+		ERR("[%s:%d] Invalid FCS\n", __func__, __LINE__);
+		return -1;
+	}
+
+	const int fcs_low_offset = fcs_offset + result;
+
+	result = _hdlc_read_byte(&fcs_low, data + fcs_low_offset, len - fcs_low_offset);
+	if (result < 1) {
+		ERR("[%s:%d] Invalid FCS\n", __func__, __LINE__);
+		return -1;
 	}
 
-	fcs = _reverse_bits_16(fcs);
-	return fcs ^ CRC_XOR_OUT;
+	// Stuffed address and the new stuffed control field
+	memcpy(prefix, data + 1, address_len);
+	result = _hdlc_write_byte(control, prefix + address_len, sizeof(prefix) - address_len);
+	if (result < 1) {
+		ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+		return -1;
+	}
+
+	const int new_control_len = result;
+	const int new_tail_offset = control_offset + new_control_len;
+
+	// Only the FCS contribution of the prefix changes, move it across the untouched tail
+	const uint16_t old_prefix_fcs = _hdlc_calculate_fcs(data + 1, tail_offset - 1);
+	const uint16_t new_prefix_fcs = _hdlc_calculate_fcs(prefix, address_len + new_control_len);
+	const uint16_t old_fcs = (fcs_high << 8) | fcs_low;
+	const uint16_t fcs = old_fcs ^ _hdlc_fcs_shift(old_prefix_fcs ^ new_prefix_fcs, tail_len);
+
+	int encoded_len = new_tail_offset + tail_len;
+	int trailer_len = 1;
+
+	trailer_len += (HIGH_BYTE(fcs) == HDLC_DELIMITER || HIGH_BYTE(fcs) == HDLC_ESCAPE) ? 2 : 1;
+	trailer_len += (LOW_BYTE(fcs) == HDLC_DELIMITER || LOW_BYTE(fcs) == HDLC_ESCAPE) ? 2 : 1;
+
+	if (encoded_len + trailer_len > size) {
+		ERR("[%s:%d] encoded_len + trailer_len > size\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (new_tail_offset != tail_offset) {
+		memmove(data + new_tail_offset, data + tail_offset, tail_len);
+	}
+
+	memcpy(data + control_offset, prefix + address_len, new_control_len);
+
+	encoded_len += _hdlc_write_byte(HIGH_BYTE(fcs), data + encoded_len, size - encoded_len);
+	encoded_len += _hdlc_write_byte(LOW_BYTE(fcs), data + encoded_len, size - encoded_len);
+	data[encoded_len++] = HDLC_DELIMITER;
+
+	return encoded_len;
 }
 
 //--------------------------------------------------
@@ -196,19 +216,15 @@ int hdlc_u_frame_control_init(hdlc_control_t *control, hdlc_control_u_frame_code
 	return 0;
 }
 
+// Writes the start flag, address, control and information field, which is what the FCS covers
 //--------------------------------------------------
-int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
+static int _hdlc_encode_body(const hdlc_frame_t *frame, uint8_t *data, int len)
 {
-	if (frame == NULL || data == NULL) {
-		ERR("[%s:%d] frame == NULL || data == NULL\n", __func__, __LINE__);
-		return -1;
-	}
-
 	int encoded_len = 0;
 	int data_len = len;
 	int result = 0;
 
-	hdlc_info_len_t info_len = frame->info_len;
+	const hdlc_info_len_t info_len = frame->info_len;
 	size_t info_byte_index = 0;
 
 	if (data_len < 1) {
@@ -220,7 +236,7 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 	data[encoded_len++] = HDLC_DELIMITER;
 
 	// Add the address
-	result = _hdlc_write_byte(frame->address, data + encoded_len, len--);
+	result = _hdlc_write_byte(frame->address, data + encoded_len, data_len - encoded_len);
 	if (result < 1) {
 		ERR("[%s:%d] result < 1\n", __func__, __LINE__);
 		return -1;
@@ -229,7 +245,7 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 	encoded_len += result;
 
 	// Add the control field
-	result = _hdlc_write_byte(frame->control.value, data + encoded_len, len--);
+	result = _hdlc_write_byte(frame->control.value, data + encoded_len, data_len - encoded_len);
 	if (result < 1) {
 		ERR("[%s:%d] result < 1\n", __func__, __LINE__);
 		return -1;
@@ -237,21 +253,33 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 
 	encoded_len += result;
 
-	// Skip the information field if it is empty
-	if (info_len != 0) {
-		while (info_len--) {
-			// Set the current information byte
-			const uint8_t info_byte = frame->info[info_byte_index++];
+	// Add the information field, copying stretches without flag or escape bytes in one go
+	while (info_byte_index < info_len) {
+		const size_t run = _hdlc_clean_run(frame->info + info_byte_index,
+						   info_len - info_byte_index);
 
-			// Add the information byte
-			result = _hdlc_write_byte(info_byte, data + encoded_len, len--);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+		if (run > 0) {
+			if ((int)run > data_len - encoded_len) {
+				ERR("[%s:%d] run > data_len - encoded_len\n", __func__, __LINE__);
 				return -1;
 			}
 
-			encoded_len += result;
+			memcpy(data + encoded_len, frame->info + info_byte_index, run);
+
+			encoded_len += (int)run;
+			info_byte_index += run;
+			continue;
 		}
+
+		// Add the information byte that needs escaping
+		result = _hdlc_write_byte(frame->info[info_byte_index++], data + encoded_len,
+					  data_len - encoded_len);
+		if (result < 1) {
+			ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+			return -1;
+		}
+
+		encoded_len += result;
 	}
 
 	if (encoded_len == 0) {
@@ -259,11 +287,18 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 		return -1;
 	}
 
-	// Calculate the FCS
-	const uint16_t fcs = _hdlc_calculate_fcs(data + 1, encoded_len - 1);
+	return encoded_len;
+}
+
+// Appends the FCS and the stop flag to a body of encoded_len bytes
+//--------------------------------------------------
+static int _hdlc_encode_trailer(uint16_t fcs, uint8_t *data, int encoded_len, int len)
+{
+	const int data_len = len;
+	int result = 0;
 
 	// Add the FCS (high byte)
-	result = _hdlc_write_byte(HIGH_BYTE(fcs), data + encoded_len, len--);
+	result = _hdlc_write_byte(HIGH_BYTE(fcs), data + encoded_len, data_len - encoded_len);
 	if (result < 1) {
 		ERR("[%s:%d] result < 1\n", __func__, __LINE__);
 		return -1;
@@ -272,7 +307,7 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 	encoded_len += result;
 
 	// Add the FCS (low byte)
-	result = _hdlc_write_byte(LOW_BYTE(fcs), data + encoded_len, len--);
+	result = _hdlc_write_byte(LOW_BYTE(fcs), data + encoded_len, data_len - encoded_len);
 	if (result < 1) {
 		ERR("[%s:%d] result < 1\n", __func__, __LINE__);
 		return -1;
@@ -292,107 +327,427 @@ int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 }
 
 //--------------------------------------------------
-int hdlc_decode(hdlc_frame_t *frame, uint8_t *data, int len)
+int hdlc_encode(const hdlc_frame_t *frame, uint8_t *data, int len)
 {
 	if (frame == NULL || data == NULL) {
 		ERR("[%s:%d] frame == NULL || data == NULL\n", __func__, __LINE__);
 		return -1;
 	}
 
-	hdlc_state_t state = HDLC_STATE_IDLE;
+	HDLC_PROBE2(encode_start, frame, frame->info_len);
 
-	int result = 0;
+	int encoded_len = _hdlc_encode_body(frame, data, len);
+	if (encoded_len < 1) {
+		ERR("[%s:%d] encoded_len < 1\n", __func__, __LINE__);
+		return -1;
+	}
 
-	uint16_t fcs = 0;
+	// Calculate the FCS
+	const uint16_t fcs = _hdlc_calculate_fcs(data + 1, encoded_len - 1);
 
-	for (int i = 0; i < len; i++) {
-		const int left = len - i;
+	encoded_len = _hdlc_encode_trailer(fcs, data, encoded_len, len);
+	if (encoded_len < 1) {
+		ERR("[%s:%d] encoded_len < 1\n", __func__, __LINE__);
+		return -1;
+	}
 
-		switch (state) {
-		case HDLC_STATE_IDLE:
-			if (data[i] == HDLC_DELIMITER) {
-				state = HDLC_STATE_ADDRESS;
-			} else {
-				ERR("[%s:%d] HDLC_DELIMITER error\n", __func__, __LINE__);
-				return -1;
-			}
-			break;
-		case HDLC_STATE_ADDRESS:
-			result = _hdlc_read_byte(&frame->address, data + i, left);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
-				return -1;
-			}
+	HDLC_PROBE3(encode_done, frame, encoded_len, fcs);
 
-			i += result - 1;
-			state = HDLC_STATE_CONTROL;
-			break;
-		case HDLC_STATE_CONTROL:
-			result = _hdlc_read_byte(&frame->control.value, data + i, left);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
-				return -1;
-			}
+	return encoded_len;
+}
 
-			i += result - 1;
-			state = HDLC_STATE_INFO;
-			break;
-		case HDLC_STATE_INFO:
-			if ((len - i) <= 3) {
-				i--;
-				state = HDLC_STATE_FCS;
-				break;
+// Encodes count frames into their own buffers. The bodies of up to HDLC_FCS_LANES frames are
+// stuffed first so their FCS can be computed side by side instead of one chain per frame.
+//--------------------------------------------------
+int hdlc_encode_batch(const hdlc_frame_t *frames, int count, uint8_t *const *data, const int *len,
+		      int *encoded_lens)
+{
+	if (frames == NULL || data == NULL || len == NULL || encoded_lens == NULL) {
+		ERR("[%s:%d] frames == NULL || data == NULL || len == NULL || encoded_lens == NULL\n",
+		    __func__, __LINE__);
+		return -1;
+	}
+
+	if (count < 0) {
+		ERR("[%s:%d] count < 0\n", __func__, __LINE__);
+		return -1;
+	}
+
+	for (int first = 0; first < count; first += HDLC_FCS_LANES) {
+		const uint8_t *lane_data[HDLC_FCS_LANES];
+		size_t lane_len[HDLC_FCS_LANES];
+		uint16_t lane_fcs[HDLC_FCS_LANES];
+
+		for (int lane = 0; lane < HDLC_FCS_LANES; lane++) {
+			const int i = first + lane;
+
+			lane_data[lane] = NULL;
+			lane_len[lane] = 0;
+			lane_fcs[lane] = CRC_INIT;
+
+			if (i >= count) {
+				continue;
 			}
 
-			result = _hdlc_read_byte(&frame->info[frame->info_len], data + i, left);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+			if (data[i] == NULL) {
+				ERR("[%s:%d] data[i] == NULL\n", __func__, __LINE__);
 				return -1;
 			}
 
-			i += result - 1;
-			frame->info_len++;
-			break;
-		case HDLC_STATE_FCS:
-			uint8_t fcs_high = 0;
-			uint8_t fcs_low = 0;
+			HDLC_PROBE2(encode_start, &frames[i], frames[i].info_len);
 
-			result = _hdlc_read_byte(&fcs_high, data + i, left);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+			const int encoded_len = _hdlc_encode_body(&frames[i], data[i], len[i]);
+			if (encoded_len < 1) {
+				ERR("[%s:%d] encoded_len < 1\n", __func__, __LINE__);
 				return -1;
 			}
 
-			i += result;
+			encoded_lens[i] = encoded_len;
+			lane_data[lane] = data[i] + 1;
+			lane_len[lane] = (size_t)(encoded_len - 1);
+		}
+
+		_hdlc_fcs_update_lanes(lane_fcs, lane_data, lane_len);
 
-			result = _hdlc_read_byte(&fcs_low, data + i, left);
-			if (result < 1) {
-				ERR("[%s:%d] result < 1\n", __func__, __LINE__);
+		for (int lane = 0; lane < HDLC_FCS_LANES && first + lane < count; lane++) {
+			const int i = first + lane;
+
+			const uint16_t fcs = _hdlc_fcs_final(lane_fcs[lane]);
+
+			const int encoded_len = _hdlc_encode_trailer(fcs, data[i], encoded_lens[i], len[i]);
+			if (encoded_len < 1) {
+				ERR("[%s:%d] encoded_len < 1\n", __func__, __LINE__);
 				return -1;
 			}
 
-			i += result - 1;
+			HDLC_PROBE3(encode_done, &frames[i], encoded_len, fcs);
+
+			encoded_lens[i] = encoded_len;
+		}
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_encode_abort(uint8_t *data, int len)
+{
+	if (data == NULL) {
+		ERR("[%s:%d] data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (len < HDLC_ABORT_LEN) {
+		ERR("[%s:%d] len < HDLC_ABORT_LEN\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// An escape followed by a flag tells the receiver to discard the frame in progress
+	data[0] = HDLC_ESCAPE;
+	data[1] = HDLC_DELIMITER;
+
+	return HDLC_ABORT_LEN;
+}
+
+//--------------------------------------------------
+static void _hdlc_encoder_put(hdlc_encoder_t *encoder, uint8_t byte, uint8_t *data, int *written,
+			      int update_fcs)
+{
+	if (byte == HDLC_DELIMITER || byte == HDLC_ESCAPE) {
+		const uint8_t inverted = byte ^ HDLC_INVERTED;
+
+		// The second half of the escape goes out first thing on the next iteration
+		data[(*written)++] = HDLC_ESCAPE;
+		encoder->pending = inverted;
+		encoder->has_pending = 1;
 
-			fcs = (fcs_high << 8) | fcs_low;
+		if (update_fcs) {
+			encoder->fcs = _hdlc_fcs_update(encoder->fcs, HDLC_ESCAPE);
+			encoder->fcs = _hdlc_fcs_update(encoder->fcs, inverted);
+		}
+	} else {
+		data[(*written)++] = byte;
+
+		if (update_fcs) {
+			encoder->fcs = _hdlc_fcs_update(encoder->fcs, byte);
+		}
+	}
+}
+
+//--------------------------------------------------
+static void _hdlc_encoder_enter_fcs(hdlc_encoder_t *encoder)
+{
+	encoder->fcs = _hdlc_fcs_final(encoder->fcs);
+	encoder->index = 0;
+	encoder->state = HDLC_STATE_FCS;
+	encoder->times.fcs = _hdlc_now(encoder->clock, encoder->clock_user);
+}
+
+//--------------------------------------------------
+int hdlc_encoder_init(hdlc_encoder_t *encoder, const hdlc_frame_t *frame)
+{
+	if (encoder == NULL || frame == NULL) {
+		ERR("[%s:%d] encoder == NULL || frame == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(encoder, 0, sizeof(*encoder));
+
+	encoder->frame = frame;
+	encoder->state = HDLC_STATE_START_FLAG;
+	encoder->fcs = CRC_INIT;
+
+	return 0;
+}
+
+// Takes effect from the next pull, init clears it again
+//--------------------------------------------------
+int hdlc_encoder_set_clock(hdlc_encoder_t *encoder, hdlc_clock_t clock, void *user)
+{
+	if (encoder == NULL) {
+		ERR("[%s:%d] encoder == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	encoder->clock = clock;
+	encoder->clock_user = user;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_encoder_pull(hdlc_encoder_t *encoder, uint8_t *data, int len)
+{
+	if (encoder == NULL || data == NULL) {
+		ERR("[%s:%d] encoder == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
 
-			if (_hdlc_calculate_fcs(data + 1, len - 4) == fcs) {
-				state = HDLC_STATE_STOP_FLAG;
+	const hdlc_frame_t *frame = encoder->frame;
+
+	int written = 0;
+
+	while (written < len) {
+		if (encoder->has_pending) {
+			data[written++] = encoder->pending;
+			encoder->has_pending = 0;
+			continue;
+		}
+
+		switch (encoder->state) {
+		case HDLC_STATE_IDLE:
+			return written;
+		case HDLC_STATE_START_FLAG:
+			data[written++] = HDLC_DELIMITER;
+			encoder->state = HDLC_STATE_ADDRESS;
+			encoder->times.first_byte = _hdlc_now(encoder->clock, encoder->clock_user);
+			break;
+		case HDLC_STATE_ADDRESS:
+			_hdlc_encoder_put(encoder, frame->address, data, &written, 1);
+			encoder->state = HDLC_STATE_CONTROL;
+			break;
+		case HDLC_STATE_CONTROL:
+			_hdlc_encoder_put(encoder, frame->control.value, data, &written, 1);
+
+			if (frame->info_len != 0) {
+				encoder->index = 0;
+				encoder->state = HDLC_STATE_INFO;
 			} else {
-				ERR("[%s:%d] FCS error\n", __func__, __LINE__);
-				return -1;
+				_hdlc_encoder_enter_fcs(encoder);
 			}
 			break;
-		case HDLC_STATE_STOP_FLAG:
-			if (data[0] == HDLC_DELIMITER) {
-				return 0;
+		case HDLC_STATE_INFO: {
+			const uint8_t *info = frame->info + encoder->index;
+			const size_t left = frame->info_len - encoder->index;
+			const size_t room = (size_t)(len - written);
+			const size_t run = _hdlc_clean_run(info, left < room ? left : room);
+
+			// Copy a stretch without flag or escape bytes in one go
+			if (run > 0) {
+				memcpy(data + written, info, run);
+				encoder->fcs = _hdlc_fcs_update_block(encoder->fcs, info, run);
+				encoder->index += run;
+				written += (int)run;
+			} else {
+				_hdlc_encoder_put(encoder, *info, data, &written, 1);
+				encoder->index++;
+			}
+
+			if (encoder->index == frame->info_len) {
+				_hdlc_encoder_enter_fcs(encoder);
 			}
 			break;
+		}
+		case HDLC_STATE_FCS:
+			if (encoder->index++ == 0) {
+				_hdlc_encoder_put(encoder, HIGH_BYTE(encoder->fcs), data, &written, 0);
+			} else {
+				_hdlc_encoder_put(encoder, LOW_BYTE(encoder->fcs), data, &written, 0);
+				encoder->state = HDLC_STATE_STOP_FLAG;
+			}
+			break;
+		case HDLC_STATE_STOP_FLAG:
+			data[written++] = HDLC_DELIMITER;
+			encoder->state = HDLC_STATE_IDLE;
+			encoder->times.flag = _hdlc_now(encoder->clock, encoder->clock_user);
+			break;
 		default:
 			ERR("[%s:%d] Unknown state\n", __func__, __LINE__);
 			return -1;
 		}
 	}
 
-	ERR("[%s:%d] No stop flag detected\n", __func__, __LINE__);
-	return -1;
+	return written;
+}
+
+//--------------------------------------------------
+int hdlc_encoder_done(const hdlc_encoder_t *encoder)
+{
+	if (encoder == NULL) {
+		ERR("[%s:%d] encoder == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return encoder->state == HDLC_STATE_IDLE && !encoder->has_pending;
+}
+
+//--------------------------------------------------
+int hdlc_encoder_started(const hdlc_encoder_t *encoder)
+{
+	if (encoder == NULL) {
+		ERR("[%s:%d] encoder == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return encoder->state != HDLC_STATE_START_FLAG;
+}
+
+//--------------------------------------------------
+int hdlc_encoder_remaining(const hdlc_encoder_t *encoder)
+{
+	if (encoder == NULL) {
+		ERR("[%s:%d] encoder == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	const hdlc_frame_t *frame = encoder->frame;
+
+	// Lower bound, escapes still to come are not counted
+	int remaining = encoder->has_pending;
+
+	switch (encoder->state) {
+	case HDLC_STATE_START_FLAG:
+		remaining += 1;
+		// fall through
+	case HDLC_STATE_ADDRESS:
+		remaining += 1;
+		// fall through
+	case HDLC_STATE_CONTROL:
+		remaining += 1 + frame->info_len + 2 + 1;
+		break;
+	case HDLC_STATE_INFO:
+		remaining += frame->info_len - encoder->index + 2 + 1;
+		break;
+	case HDLC_STATE_FCS:
+		remaining += 2 - encoder->index + 1;
+		break;
+	case HDLC_STATE_STOP_FLAG:
+		remaining += 1;
+		break;
+	default:
+		break;
+	}
+
+	return remaining;
+}
+
+// With room for a single byte the flag that completes the abort is left for the next pull
+//--------------------------------------------------
+int hdlc_encoder_abort(hdlc_encoder_t *encoder, uint8_t *data, int len)
+{
+	if (encoder == NULL || data == NULL) {
+		ERR("[%s:%d] encoder == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (len < 1) {
+		ERR("[%s:%d] len < 1\n", __func__, __LINE__);
+		return -1;
+	}
+
+	int result = 0;
+
+	if (encoder->has_pending) {
+		// The escape is already on the wire, only the flag is missing
+		data[0] = HDLC_DELIMITER;
+		encoder->has_pending = 0;
+		result = 1;
+	} else if (encoder->state != HDLC_STATE_START_FLAG && encoder->state != HDLC_STATE_IDLE) {
+		if (len >= HDLC_ABORT_LEN) {
+			result = hdlc_encode_abort(data, len);
+		} else {
+			data[0] = HDLC_ESCAPE;
+			encoder->pending = HDLC_DELIMITER;
+			encoder->has_pending = 1;
+			result = 1;
+		}
+	}
+
+	encoder->state = HDLC_STATE_IDLE;
+
+	return result;
+}
+
+//--------------------------------------------------
+int hdlc_encoded_set_control(uint8_t *data, int len, int size, uint8_t control)
+{
+	if (data == NULL) {
+		ERR("[%s:%d] data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// Flags, address, control and FCS
+	if (len < 6 || size < len) {
+		ERR("[%s:%d] len < 6 || size < len\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (data[0] != HDLC_DELIMITER || data[len - 1] != HDLC_DELIMITER) {
+		ERR("[%s:%d] HDLC_DELIMITER error\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// Walk back over the stuffed FCS, an escape byte never appears as the second half of a pair
+	const int fcs_low_offset = (data[len - 3] == HDLC_ESCAPE) ? len - 3 : len - 2;
+	const int fcs_offset =
+		(data[fcs_low_offset - 2] == HDLC_ESCAPE) ? fcs_low_offset - 2 : fcs_low_offset - 1;
+
+	const int address_len = (data[1] == HDLC_ESCAPE) ? 2 : 1;
+	const int control_offset = 1 + address_len;
+	const int control_len = (data[control_offset] == HDLC_ESCAPE) ? 2 : 1;
+	const int tail_len = fcs_offset - control_offset - control_len;
+
+	if (tail_len < 0) {
+		ERR("[%s:%d] tail_len < 0\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return _hdlc_patch_control(data, len, size, tail_len, control);
+}
+
+//--------------------------------------------------
+int hdlc_decode(hdlc_frame_t *frame, uint8_t *data, int len)
+{
+	if (frame == NULL || data == NULL) {
+		ERR("[%s:%d] frame == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	HDLC_PROBE2(decode_start, data, len);
+
+	const int result = _hdlc_deframer_decode(frame, data, len);
+
+	HDLC_PROBE2(decode_done, frame, result);
+
+	return result;
 }
\ No newline at end of file
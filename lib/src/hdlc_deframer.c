@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_deframer.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+typedef enum {
+	HDLC_DEFRAMER_CLASS_DATA,
+	HDLC_DEFRAMER_CLASS_ESCAPE,
+	HDLC_DEFRAMER_CLASS_FLAG,
+	HDLC_DEFRAMER_CLASS_COUNT,
+} hdlc_deframer_class_t;
+
+typedef enum {
+	HDLC_DEFRAMER_ACTION_NONE,
+	HDLC_DEFRAMER_ACTION_RESTART,       // Start collecting a new frame
+	HDLC_DEFRAMER_ACTION_STORE,         // Take the byte as is
+	HDLC_DEFRAMER_ACTION_STORE_ESCAPED, // Take the byte with the escape undone
+	HDLC_DEFRAMER_ACTION_END,           // Check and deliver the frame, then restart
+	HDLC_DEFRAMER_ACTION_ABORT,         // Drop the frame, then restart
+	HDLC_DEFRAMER_ACTION_ESCAPE_ERROR,  // Drop the frame and hunt for the next flag
+} hdlc_deframer_action_t;
+
+#ifdef HDLC_PROFILE_SMALL
+//--------------------------------------------------
+static inline uint8_t _hdlc_deframer_classify(uint8_t byte)
+{
+	if (byte == HDLC_DELIMITER) {
+		return HDLC_DEFRAMER_CLASS_FLAG;
+	}
+
+	return byte == HDLC_ESCAPE ? HDLC_DEFRAMER_CLASS_ESCAPE : HDLC_DEFRAMER_CLASS_DATA;
+}
+#else
+//--------------------------------------------------
+static const uint8_t _hdlc_deframer_class[256] = {
+	[HDLC_ESCAPE] = HDLC_DEFRAMER_CLASS_ESCAPE,
+	[HDLC_DELIMITER] = HDLC_DEFRAMER_CLASS_FLAG,
+};
+
+//--------------------------------------------------
+static inline uint8_t _hdlc_deframer_classify(uint8_t byte)
+{
+	return _hdlc_deframer_class[byte];
+}
+#endif
+
+// Next state in the low nibble, action in the high nibble
+#define TRANSITION(state, action)                                                                  \
+	(uint8_t)(HDLC_DEFRAMER_STATE_##state | HDLC_DEFRAMER_ACTION_##action << 4)
+
+//--------------------------------------------------
+static const uint8_t _hdlc_deframer_table[HDLC_DEFRAMER_STATE_COUNT][HDLC_DEFRAMER_CLASS_COUNT] = {
+	[HDLC_DEFRAMER_STATE_HUNT] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(HUNT, NONE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(HUNT, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(START, RESTART),
+	},
+	[HDLC_DEFRAMER_STATE_START] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(ESCAPED, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(START, RESTART),
+	},
+	[HDLC_DEFRAMER_STATE_DATA] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(ESCAPED, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(START, END),
+	},
+	[HDLC_DEFRAMER_STATE_ESCAPED] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE_ESCAPED),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(HUNT, ESCAPE_ERROR),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(START, ABORT),
+	},
+};
+
+// A single frame that fills a buffer, as hdlc_decode takes it: flags inside are data and an escape
+// undoes any byte that follows it. Whatever ends the frame is decided by the caller.
+//--------------------------------------------------
+static const uint8_t _hdlc_deframer_single_table[HDLC_DEFRAMER_STATE_COUNT]
+						[HDLC_DEFRAMER_CLASS_COUNT] = {
+	[HDLC_DEFRAMER_STATE_HUNT] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(HUNT, NONE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(HUNT, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(HUNT, NONE),
+	},
+	[HDLC_DEFRAMER_STATE_START] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(ESCAPED, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(DATA, STORE),
+	},
+	[HDLC_DEFRAMER_STATE_DATA] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(ESCAPED, NONE),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(DATA, STORE),
+	},
+	[HDLC_DEFRAMER_STATE_ESCAPED] = {
+		[HDLC_DEFRAMER_CLASS_DATA] = TRANSITION(DATA, STORE_ESCAPED),
+		[HDLC_DEFRAMER_CLASS_ESCAPE] = TRANSITION(DATA, STORE_ESCAPED),
+		[HDLC_DEFRAMER_CLASS_FLAG] = TRANSITION(DATA, STORE_ESCAPED),
+	},
+};
+
+//--------------------------------------------------
+static void _hdlc_deframer_restart(hdlc_deframer_t *deframer)
+{
+	deframer->fcs = CRC_INIT;
+	deframer->count = 0;
+	deframer->encoded_len = 0;
+	deframer->delay_escaped = 0;
+	deframer->delay_len = 0;
+}
+
+//--------------------------------------------------
+static int _hdlc_deframer_commit(hdlc_deframer_t *deframer, uint8_t byte)
+{
+	hdlc_frame_t *frame = deframer->frame;
+
+	if (deframer->count == 0) {
+		HDLC_PROBE1(frame_start, deframer);
+		frame->address = byte;
+	} else if (deframer->count == 1) {
+		frame->control.value = byte;
+	} else if (deframer->count > 1 &&
+		   deframer->info_offset + deframer->count - 2 < HDLC_INFO_MAX_LEN) {
+		frame->info[deframer->info_offset + deframer->count - 2] = byte;
+	} else {
+		return -1;
+	}
+
+	deframer->count++;
+
+	return 0;
+}
+
+//--------------------------------------------------
+static int _hdlc_deframer_take(hdlc_deframer_t *deframer, uint8_t byte)
+{
+	if (_hdlc_deframer_commit(deframer, byte) < 0) {
+		deframer->stats.length_errors++;
+		HDLC_PROBE2(length_error, deframer, deframer->count);
+		deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+		return -1;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+static int _hdlc_deframer_release(hdlc_deframer_t *deframer, uint8_t byte, uint8_t escaped)
+{
+	// The FCS covers the bytes as they were sent, escapes included
+	if (escaped) {
+		deframer->fcs = _hdlc_fcs_update(deframer->fcs, HDLC_ESCAPE);
+		deframer->fcs = _hdlc_fcs_update(deframer->fcs, byte ^ HDLC_INVERTED);
+	} else {
+		deframer->fcs = _hdlc_fcs_update(deframer->fcs, byte);
+	}
+
+	return _hdlc_deframer_take(deframer, byte);
+}
+
+// The FCS sits at the end of the frame and is only known to be the FCS once the closing flag
+// arrives, so every byte is held back for two bytes before it is added to the FCS and the frame
+//--------------------------------------------------
+static void _hdlc_deframer_store(hdlc_deframer_t *deframer, uint8_t byte, uint8_t escaped)
+{
+	if (deframer->delay_len == 0 && deframer->count == 0) {
+		deframer->first_byte = _hdlc_now(deframer->clock, deframer->clock_user);
+	}
+
+	if (deframer->delay_len == 2) {
+		if (_hdlc_deframer_release(deframer, deframer->delay[0], deframer->delay_escaped & 1) <
+		    0) {
+			return;
+		}
+
+		deframer->delay[0] = deframer->delay[1];
+		deframer->delay_escaped >>= 1;
+		deframer->delay_len = 1;
+	}
+
+	deframer->delay[deframer->delay_len] = byte;
+	deframer->delay_escaped |= escaped << deframer->delay_len;
+	deframer->delay_len++;
+}
+
+#ifndef HDLC_PROFILE_SMALL
+// Stores at least three unstuffed bytes taken from len bytes on the line. All but the last two go
+// straight into the FCS and the frame, tail_escaped tells whether those two came in escaped.
+//--------------------------------------------------
+static void _hdlc_deframer_store_block(hdlc_deframer_t *deframer, const uint8_t *data, int len,
+				       const uint8_t *out, int out_len, uint8_t tail_escaped)
+{
+	for (int i = 0; i < deframer->delay_len; i++) {
+		if (_hdlc_deframer_release(deframer, deframer->delay[i],
+					   (deframer->delay_escaped >> i) & 1) < 0) {
+			return;
+		}
+	}
+
+	// The FCS runs over the bytes as sent, up to where the last two start
+	const int tail_len = 2 + (tail_escaped & 1) + ((tail_escaped >> 1) & 1);
+	deframer->fcs = _hdlc_fcs_update_block(deframer->fcs, data, (size_t)(len - tail_len));
+
+	const int bulk = out_len - 2;
+
+	int i = 0;
+	while (i < bulk && deframer->count < 2) {
+		_hdlc_deframer_commit(deframer, out[i++]);
+	}
+
+	if (i < bulk) {
+		uint8_t *info = deframer->frame->info + deframer->info_offset + deframer->count - 2;
+		const int room = HDLC_INFO_MAX_LEN - (deframer->info_offset + deframer->count - 2);
+
+		if (bulk - i > room) {
+			deframer->stats.length_errors++;
+			HDLC_PROBE2(length_error, deframer, deframer->count + bulk - i);
+			deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+
+			// What fits is kept, as it would have been a byte at a time
+			if (room > 0) {
+				memcpy(info, out + i, room);
+				deframer->count += room;
+			}
+			return;
+		}
+
+		memcpy(info, out + i, bulk - i);
+		deframer->count += bulk - i;
+	}
+
+	deframer->delay[0] = out[out_len - 2];
+	deframer->delay[1] = out[out_len - 1];
+	deframer->delay_escaped = tail_escaped;
+	deframer->delay_len = 2;
+}
+#endif
+
+//--------------------------------------------------
+static int _hdlc_deframer_end(hdlc_deframer_t *deframer)
+{
+	const uint64_t flag = _hdlc_now(deframer->clock, deframer->clock_user);
+
+	// Address, control and FCS at the very least
+	if (deframer->count < 2 || deframer->delay_len < 2) {
+		deframer->stats.length_errors++;
+		HDLC_PROBE2(length_error, deframer, deframer->count);
+		return 0;
+	}
+
+	const uint16_t fcs = (deframer->delay[0] << 8) | deframer->delay[1];
+
+	if (_hdlc_fcs_final(deframer->fcs) != fcs) {
+		deframer->stats.fcs_errors++;
+		HDLC_PROBE3(fcs_error, deframer, _hdlc_fcs_final(deframer->fcs), fcs);
+		return 0;
+	}
+
+	const uint64_t fcs_verified = _hdlc_now(deframer->clock, deframer->clock_user);
+
+	deframer->frame->info_len = (hdlc_info_len_t)(deframer->info_offset + deframer->count - 2);
+	deframer->stats.frames++;
+
+	HDLC_PROBE3(frame_done, deframer, deframer->frame->info_len, deframer->encoded_len);
+
+	if (deframer->cb != NULL) {
+		hdlc_frame_desc_t desc = {
+			.frame = deframer->frame,
+			.encoded_len = deframer->encoded_len,
+			.times = {
+				.first_byte = deframer->first_byte,
+				.flag = flag,
+				.fcs = fcs_verified,
+			},
+		};
+
+		desc.times.delivered = _hdlc_now(deframer->clock, deframer->clock_user);
+
+		deframer->cb(deframer->user, &desc);
+	}
+
+	return 1;
+}
+
+//--------------------------------------------------
+static int _hdlc_deframer_run(hdlc_deframer_t *deframer,
+			      const uint8_t (*table)[HDLC_DEFRAMER_CLASS_COUNT], const uint8_t *data,
+			      int len)
+{
+#ifndef HDLC_PROFILE_SMALL
+	const hdlc_unstuff_fn_t unstuff = _hdlc_kernels()->unstuff;
+#endif
+
+	int frames = 0;
+
+	for (int i = 0; i < len; i++) {
+#ifndef HDLC_PROFILE_SMALL
+		// Inside a frame whole blocks bypass the table, vector unstuffing where the CPU has it
+		// and otherwise stretches without flag or escape bytes
+		if (deframer->state == HDLC_DEFRAMER_STATE_DATA) {
+			uint8_t out[HDLC_UNSTUFF_BLOCK];
+			int out_len = 0;
+			uint8_t tail_escaped = 0;
+
+			int used = 0;
+			if (unstuff != NULL) {
+				used = unstuff(data + i, len - i, out, &out_len, &tail_escaped);
+			}
+
+			if (used > 0) {
+				_hdlc_deframer_store_block(deframer, data + i, used, out, out_len,
+							   tail_escaped);
+			} else {
+				used = (int)_hdlc_clean_run(data + i, (size_t)(len - i));
+
+				if (used > 2) {
+					_hdlc_deframer_store_block(deframer, data + i, used, data + i,
+								   used, 0);
+				}
+			}
+
+			if (used > 2) {
+				deframer->encoded_len += used;
+				i += used - 1;
+				continue;
+			}
+		}
+#endif
+
+		const uint8_t byte = data[i];
+		const uint8_t transition = table[deframer->state][_hdlc_deframer_classify(byte)];
+
+		deframer->state = (hdlc_deframer_state_t)(transition & 0x0F);
+		deframer->encoded_len++;
+
+		switch ((hdlc_deframer_action_t)(transition >> 4)) {
+		case HDLC_DEFRAMER_ACTION_NONE:
+			break;
+		case HDLC_DEFRAMER_ACTION_RESTART:
+			_hdlc_deframer_restart(deframer);
+			break;
+		case HDLC_DEFRAMER_ACTION_STORE:
+			_hdlc_deframer_store(deframer, byte, 0);
+			break;
+		case HDLC_DEFRAMER_ACTION_STORE_ESCAPED:
+			_hdlc_deframer_store(deframer, byte ^ HDLC_INVERTED, 1);
+			break;
+		case HDLC_DEFRAMER_ACTION_END:
+			frames += _hdlc_deframer_end(deframer);
+			_hdlc_deframer_restart(deframer);
+			break;
+		case HDLC_DEFRAMER_ACTION_ABORT:
+			deframer->stats.aborts++;
+			HDLC_PROBE1(abort, deframer);
+			_hdlc_deframer_restart(deframer);
+			break;
+		case HDLC_DEFRAMER_ACTION_ESCAPE_ERROR:
+			deframer->stats.escape_errors++;
+			HDLC_PROBE1(escape_error, deframer);
+			break;
+		}
+	}
+
+	return frames;
+}
+
+// Reads one byte at i, undoing an escape. Returns where the next one starts, -1 when the escape
+// has nothing after it.
+//--------------------------------------------------
+static int _hdlc_deframer_read(const uint8_t *data, int len, int i, uint8_t *byte)
+{
+	if (data[i] != HDLC_ESCAPE) {
+		*byte = data[i];
+		return i + 1;
+	}
+
+	if (i + 1 >= len) {
+		return -1;
+	}
+
+	*byte = data[i + 1] ^ HDLC_INVERTED;
+
+	return i + 2;
+}
+
+// Decodes the one frame that fills the buffer and appends its information to the frame's. The FCS
+// is found walking back from the last byte, which ends the frame whatever its value. Address and
+// control are read even when they run into the FCS, the bytes before the FCS go through the table
+// and the unstuffing kernels like any other frame.
+//--------------------------------------------------
+int _hdlc_deframer_decode(hdlc_frame_t *frame, const uint8_t *data, int len)
+{
+	hdlc_deframer_t deframer;
+	uint8_t byte = 0;
+
+	if (len < 1 || data[0] != HDLC_DELIMITER) {
+		ERR("[%s:%d] HDLC_DELIMITER error\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// The FCS bytes may be escaped as well, walk back from the stop flag to find where they start
+	int fcs_offset = len - 3;
+	if (len >= 6) {
+		const int fcs_low_offset = (data[len - 3] == HDLC_ESCAPE) ? len - 3 : len - 2;
+
+		fcs_offset = (data[fcs_low_offset - 2] == HDLC_ESCAPE) ? fcs_low_offset - 2
+								       : fcs_low_offset - 1;
+	}
+
+	hdlc_deframer_init(&deframer, frame, NULL, NULL);
+	deframer.state = HDLC_DEFRAMER_STATE_START;
+	deframer.info_offset = frame->info_len;
+
+	int i = 1;
+	if (fcs_offset > 1) {
+		_hdlc_deframer_run(&deframer, _hdlc_deframer_single_table, data + 1, fcs_offset - 1);
+		i = fcs_offset;
+	}
+
+	for (int j = 0; j < deframer.delay_len && deframer.state != HDLC_DEFRAMER_STATE_HUNT; j++) {
+		_hdlc_deframer_release(&deframer, deframer.delay[j], (deframer.delay_escaped >> j) & 1);
+	}
+
+	deframer.delay_len = 0;
+
+	// An escape right before the FCS takes the first FCS byte along, the FCS stops short of it
+	if (deframer.state == HDLC_DEFRAMER_STATE_ESCAPED) {
+		deframer.fcs = _hdlc_fcs_update(deframer.fcs, HDLC_ESCAPE);
+		_hdlc_deframer_take(&deframer, data[i++] ^ HDLC_INVERTED);
+	}
+
+	if (deframer.count > 2) {
+		frame->info_len = (hdlc_info_len_t)(deframer.info_offset + deframer.count - 2);
+	}
+
+	if (deframer.state == HDLC_DEFRAMER_STATE_HUNT) {
+		ERR("[%s:%d] info_len >= HDLC_INFO_MAX_LEN\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// Address, control and both FCS bytes, then anything at all as the stop flag
+	while (deframer.count < 2 || deframer.delay_len < 2) {
+		if (i >= len) {
+			ERR("[%s:%d] No stop flag detected\n", __func__, __LINE__);
+			return -1;
+		}
+
+		i = _hdlc_deframer_read(data, len, i, &byte);
+		if (i < 0) {
+			deframer.stats.escape_errors++;
+			HDLC_PROBE1(escape_error, &deframer);
+			ERR("[%s:%d] i < 0\n", __func__, __LINE__);
+			return -1;
+		}
+
+		if (deframer.count < 2) {
+			_hdlc_deframer_commit(&deframer, byte);
+		} else {
+			deframer.delay[deframer.delay_len++] = byte;
+		}
+	}
+
+	if (i >= len) {
+		ERR("[%s:%d] No stop flag detected\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (_hdlc_deframer_end(&deframer) < 1) {
+		ERR("[%s:%d] FCS error\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_deframer_init(hdlc_deframer_t *deframer, hdlc_frame_t *frame, hdlc_deframer_cb_t cb,
+		       void *user)
+{
+	if (deframer == NULL || frame == NULL) {
+		ERR("[%s:%d] deframer == NULL || frame == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(deframer, 0, sizeof(*deframer));
+
+	deframer->frame = frame;
+	deframer->cb = cb;
+	deframer->user = user;
+	deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+
+	_hdlc_deframer_restart(deframer);
+
+	return 0;
+}
+
+// Timestamps are taken from the next frame on, a NULL clock turns them off again
+//--------------------------------------------------
+int hdlc_deframer_set_clock(hdlc_deframer_t *deframer, hdlc_clock_t clock, void *user)
+{
+	if (deframer == NULL) {
+		ERR("[%s:%d] deframer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	deframer->clock = clock;
+	deframer->clock_user = user;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_deframer_reset(hdlc_deframer_t *deframer)
+{
+	if (deframer == NULL) {
+		ERR("[%s:%d] deframer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	deframer->state = HDLC_DEFRAMER_STATE_HUNT;
+	_hdlc_deframer_restart(deframer);
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_deframer_push(hdlc_deframer_t *deframer, const uint8_t *data, int len)
+{
+	if (deframer == NULL || data == NULL) {
+		ERR("[%s:%d] deframer == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return _hdlc_deframer_run(deframer, _hdlc_deframer_table, data, len);
+}
\ No newline at end of file
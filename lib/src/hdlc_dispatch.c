@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_private.h"
+
+#include <stdlib.h>
+
+typedef struct {
+	const char *name;
+	int (*supported)(void);
+	hdlc_kernels_t kernels;
+} hdlc_dispatch_entry_t;
+
+//--------------------------------------------------
+static int _hdlc_dispatch_always(void)
+{
+	return 1;
+}
+
+//--------------------------------------------------
+static const hdlc_dispatch_entry_t _hdlc_dispatch_entries[HDLC_KERNELS_COUNT] = {
+	[HDLC_KERNELS_SCALAR] = {"scalar", _hdlc_dispatch_always, {NULL}},
+	[HDLC_KERNELS_AVX512_VBMI2] = {"avx512_vbmi2", _hdlc_cpu_has_avx512_vbmi2,
+				       {_hdlc_unstuff_avx512}},
+};
+
+// Bound on first use or by hdlc_dispatch_select(), whichever thread gets there, so both are only
+// accessed atomically
+const hdlc_kernels_t *_hdlc_active_kernels;
+static hdlc_kernels_id_t _hdlc_active_id;
+
+// The CPU is asked once, every probe after the first gives the same answer. Racing threads may
+// both ask, they store the same result.
+//--------------------------------------------------
+static int _hdlc_dispatch_cached_supported(hdlc_kernels_id_t id)
+{
+	static int8_t supported[HDLC_KERNELS_COUNT];
+
+	int8_t result = __atomic_load_n(&supported[id], __ATOMIC_RELAXED);
+
+	if (result == 0) {
+		result = _hdlc_dispatch_entries[id].supported() ? 1 : -1;
+		__atomic_store_n(&supported[id], result, __ATOMIC_RELAXED);
+	}
+
+	return result > 0;
+}
+
+//--------------------------------------------------
+static void _hdlc_dispatch_bind(hdlc_kernels_id_t id)
+{
+	__atomic_store_n(&_hdlc_active_id, id, __ATOMIC_RELAXED);
+	__atomic_store_n(&_hdlc_active_kernels, &_hdlc_dispatch_entries[id].kernels,
+			 __ATOMIC_RELEASE);
+}
+
+// Binds the best supported kernels unless HDLC_KERNELS names others the CPU supports
+//--------------------------------------------------
+void _hdlc_dispatch_probe(void)
+{
+	hdlc_kernels_id_t best = HDLC_KERNELS_SCALAR;
+
+	for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+		if (_hdlc_dispatch_cached_supported((hdlc_kernels_id_t)id)) {
+			best = (hdlc_kernels_id_t)id;
+		}
+	}
+
+	const char *name = getenv("HDLC_KERNELS");
+	if (name != NULL) {
+		int found = 0;
+
+		for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+			if (strcmp(name, _hdlc_dispatch_entries[id].name) != 0) {
+				continue;
+			}
+
+			found = 1;
+
+			if (_hdlc_dispatch_cached_supported((hdlc_kernels_id_t)id)) {
+				best = (hdlc_kernels_id_t)id;
+			} else {
+				ERR("[%s:%d] %s not supported by this CPU\n", __func__, __LINE__,
+				    _hdlc_dispatch_entries[id].name);
+			}
+		}
+
+		if (!found) {
+			ERR("[%s:%d] unknown HDLC_KERNELS value\n", __func__, __LINE__);
+		}
+	}
+
+	_hdlc_dispatch_bind(best);
+}
+
+//--------------------------------------------------
+int hdlc_dispatch_supported(hdlc_kernels_id_t id)
+{
+	if ((int)id < 0 || id >= HDLC_KERNELS_COUNT) {
+		return 0;
+	}
+
+	return _hdlc_dispatch_cached_supported(id);
+}
+
+//--------------------------------------------------
+int hdlc_dispatch_select(hdlc_kernels_id_t id)
+{
+	if (!hdlc_dispatch_supported(id)) {
+		ERR("[%s:%d] !hdlc_dispatch_supported(id)\n", __func__, __LINE__);
+		return -1;
+	}
+
+	_hdlc_dispatch_bind(id);
+
+	return 0;
+}
+
+//--------------------------------------------------
+hdlc_kernels_id_t hdlc_dispatch_active(void)
+{
+	_hdlc_kernels();
+
+	return __atomic_load_n(&_hdlc_active_id, __ATOMIC_RELAXED);
+}
+
+//--------------------------------------------------
+const char *hdlc_dispatch_name(hdlc_kernels_id_t id)
+{
+	if ((int)id < 0 || id >= HDLC_KERNELS_COUNT) {
+		return NULL;
+	}
+
+	return _hdlc_dispatch_entries[id].name;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_private.h"
+
+#ifndef HDLC_PROFILE_SMALL
+// Bit reflected CRC-16/ISO-HDLC table, one entry per value of the low byte of the register
+//--------------------------------------------------
+static const uint16_t _hdlc_fcs_table[256] = {
+	0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+	0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+	0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+	0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+	0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+	0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+	0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+	0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+	0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+	0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+	0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+	0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+	0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+	0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+	0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+	0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+	0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+	0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+	0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+	0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+	0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+	0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+	0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+	0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+	0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+	0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+	0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+	0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+	0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+	0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+	0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+	0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
+};
+#endif
+
+// Multiplies two polynomials modulo the CRC polynomial, both in the bit reflected domain of the
+// final FCS where x^0 is the most significant bit
+//--------------------------------------------------
+static uint16_t _hdlc_fcs_multmodp(uint16_t a, uint16_t b)
+{
+	uint16_t m = 0x8000;
+	uint16_t p = 0;
+
+	if (a == 0) {
+		return 0;
+	}
+
+	for (;;) {
+		if (a & m) {
+			p ^= b;
+			if ((a & (m - 1)) == 0) {
+				break;
+			}
+		}
+
+		m >>= 1;
+		b = (b & 1) ? (b >> 1) ^ CRC_POLY_REFLECTED : b >> 1;
+	}
+
+	return p;
+}
+
+#ifdef HDLC_PROFILE_SMALL
+// Bit at a time, no table, the register is bit reflected like the table driven version
+//--------------------------------------------------
+uint16_t _hdlc_fcs_update(uint16_t fcs, uint8_t byte)
+{
+	fcs ^= byte;
+
+	for (int bit = 0; bit < 8; bit++) {
+		fcs = (fcs & 1) ? (fcs >> 1) ^ CRC_POLY_REFLECTED : fcs >> 1;
+	}
+
+	return fcs;
+}
+
+//--------------------------------------------------
+uint16_t _hdlc_fcs_update_block(uint16_t fcs, const uint8_t *data, size_t len)
+{
+	while (len-- > 0) {
+		fcs = _hdlc_fcs_update(fcs, *data++);
+	}
+
+	return fcs;
+}
+
+//--------------------------------------------------
+void _hdlc_fcs_update_lanes(uint16_t *fcs, const uint8_t *const *data, const size_t *len)
+{
+	for (int lane = 0; lane < HDLC_FCS_LANES; lane++) {
+		fcs[lane] = _hdlc_fcs_update_block(fcs[lane], data[lane], len[lane]);
+	}
+}
+#else
+// The register is kept bit reflected so every byte costs a single table lookup
+//--------------------------------------------------
+uint16_t _hdlc_fcs_update(uint16_t fcs, uint8_t byte)
+{
+	return (fcs >> 8) ^ _hdlc_fcs_table[(fcs ^ byte) & 0xFF];
+}
+
+//--------------------------------------------------
+uint16_t _hdlc_fcs_update_block(uint16_t fcs, const uint8_t *data, size_t len)
+{
+	while (len-- > 0) {
+		fcs = (fcs >> 8) ^ _hdlc_fcs_table[(fcs ^ *data++) & 0xFF];
+	}
+
+	return fcs;
+}
+
+// Advances HDLC_FCS_LANES independent FCS values. One table lookup depends on the one before it,
+// so a single frame leaves the CPU waiting on load latency. Interleaving the lanes over their
+// common length keeps several lookups in flight, the rest of each lane is finished on its own.
+//--------------------------------------------------
+void _hdlc_fcs_update_lanes(uint16_t *fcs, const uint8_t *const *data, const size_t *len)
+{
+	size_t common = len[0];
+	for (int lane = 1; lane < HDLC_FCS_LANES; lane++) {
+		if (len[lane] < common) {
+			common = len[lane];
+		}
+	}
+
+	// Full width registers, 16 bit lanes get packed into one vector register and serialised again
+	uint32_t fcs0 = fcs[0];
+	uint32_t fcs1 = fcs[1];
+	uint32_t fcs2 = fcs[2];
+	uint32_t fcs3 = fcs[3];
+
+	for (size_t i = 0; i < common; i++) {
+		fcs0 = (fcs0 >> 8) ^ _hdlc_fcs_table[(fcs0 ^ data[0][i]) & 0xFF];
+		fcs1 = (fcs1 >> 8) ^ _hdlc_fcs_table[(fcs1 ^ data[1][i]) & 0xFF];
+		fcs2 = (fcs2 >> 8) ^ _hdlc_fcs_table[(fcs2 ^ data[2][i]) & 0xFF];
+		fcs3 = (fcs3 >> 8) ^ _hdlc_fcs_table[(fcs3 ^ data[3][i]) & 0xFF];
+	}
+
+	fcs[0] = (uint16_t)fcs0;
+	fcs[1] = (uint16_t)fcs1;
+	fcs[2] = (uint16_t)fcs2;
+	fcs[3] = (uint16_t)fcs3;
+
+	for (int lane = 0; lane < HDLC_FCS_LANES; lane++) {
+		if (len[lane] > common) {
+			fcs[lane] = _hdlc_fcs_update_block(fcs[lane], data[lane] + common,
+							   len[lane] - common);
+		}
+	}
+}
+#endif
+
+//--------------------------------------------------
+uint16_t _hdlc_fcs_final(uint16_t fcs)
+{
+	return fcs ^ CRC_XOR_OUT;
+}
+
+// CRC-16/ISO-HDLC: x^16 + x^12 + x^5 + 1 (0x1021)
+//--------------------------------------------------
+uint16_t _hdlc_calculate_fcs(const uint8_t *data, int len)
+{
+	if (len <= 0) {
+		return _hdlc_fcs_final(CRC_INIT);
+	}
+
+	return _hdlc_fcs_final(_hdlc_fcs_update_block(CRC_INIT, data, (size_t)len));
+}
+
+#ifdef HDLC_PROFILE_SMALL
+// The CRC is linear, so the difference between two FCS values advanced over len more bytes is
+// the difference multiplied by x^(8 * len). Square and multiply keeps this O(log len).
+//--------------------------------------------------
+uint16_t _hdlc_fcs_shift(uint16_t delta, size_t len)
+{
+	uint16_t power = 0x0080; // x^8
+
+	while (len != 0) {
+		if (len & 1) {
+			delta = _hdlc_fcs_multmodp(power, delta);
+		}
+
+		power = _hdlc_fcs_multmodp(power, power);
+		len >>= 1;
+	}
+
+	return delta;
+}
+#else
+// x^(8 * 2^k) modulo the polynomial, bit reflected like the register. Squaring again after the
+// last entry gives the first one back, so larger k wrap around.
+//--------------------------------------------------
+#define HDLC_FCS_X8N_PERIOD 15
+
+static const uint16_t _hdlc_fcs_x8n_table[HDLC_FCS_X8N_PERIOD] = {
+	0x0080, 0x8408, 0x0CEC, 0x861D, 0x3F75, 0x9471, 0x3FC8, 0x236C,
+	0x0ABF, 0x7955, 0x3811, 0x1A22, 0x4000, 0x2000, 0x0800,
+};
+
+// The CRC is linear, so the difference between two FCS values advanced over len more bytes is
+// the difference multiplied by x^(8 * len), one table power per set bit of len.
+//--------------------------------------------------
+uint16_t _hdlc_fcs_shift(uint16_t delta, size_t len)
+{
+	int k = 0;
+
+	while (len != 0) {
+		if (len & 1) {
+			delta = _hdlc_fcs_multmodp(_hdlc_fcs_x8n_table[k], delta);
+		}
+
+		len >>= 1;
+		k = (k + 1) % HDLC_FCS_X8N_PERIOD;
+	}
+
+	return delta;
+}
+#endif
+
+//--------------------------------------------------
+int hdlc_fcs_calculate(const uint8_t *data, int len, uint16_t *fcs)
+{
+	if (data == NULL || fcs == NULL) {
+		ERR("[%s:%d] data == NULL || fcs == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (len < 0) {
+		ERR("[%s:%d] len < 0\n", __func__, __LINE__);
+		return -1;
+	}
+
+	*fcs = _hdlc_calculate_fcs(data, len);
+
+	return 0;
+}
+
+// Initial value and final XOR are the same, so they cancel out of the shifted difference
+//--------------------------------------------------
+uint16_t hdlc_fcs_combine(uint16_t fcs_a, uint16_t fcs_b, size_t len_b)
+{
+	return _hdlc_fcs_shift(fcs_a, len_b) ^ fcs_b;
+}
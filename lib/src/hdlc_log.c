@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_private.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+//--------------------------------------------------
+int hdlc_log_format(const hdlc_log_event_t *event, char *buf, int len)
+{
+	if (event == NULL || event->fmt == NULL || buf == NULL || len < 1) {
+		return -1;
+	}
+
+	int written = 0;
+	int value = 0;
+
+	for (const char *p = event->fmt; *p != '\0' && written < len - 1; p++) {
+		if (p[0] != '%' || p[1] == '\0') {
+			buf[written++] = *p;
+			continue;
+		}
+
+		p++;
+
+		if (*p == '%') {
+			buf[written++] = '%';
+			continue;
+		}
+
+		const uint64_t arg = value < event->count ? event->values[value++] : 0;
+		int result = 0;
+
+		if (*p == 's') {
+			const char *str = (const char *)(uintptr_t)arg;
+			result = snprintf(buf + written, len - written, "%s", str ? str : "(null)");
+		} else {
+			result = snprintf(buf + written, len - written, "%d", (int)arg);
+		}
+
+		if (result < 0) {
+			return -1;
+		}
+
+		written = result < len - written ? written + result : len - 1;
+	}
+
+	buf[written] = '\0';
+
+	return written;
+}
+
+#ifdef HDLC_LOG_ENABLED
+
+#include <stdatomic.h>
+
+typedef struct {
+	atomic_uint head; // Written by the owning thread only
+	atomic_uint tail; // Written by the draining thread only
+	atomic_int owned;
+	hdlc_log_event_t events[HDLC_LOG_RING_LEN];
+} hdlc_log_ring_t;
+
+static hdlc_log_ring_t _hdlc_log_rings[HDLC_LOG_THREADS];
+static atomic_uint _hdlc_log_dropped;
+static atomic_flag _hdlc_log_draining = ATOMIC_FLAG_INIT;
+static _Thread_local hdlc_log_ring_t *_hdlc_log_ring;
+
+// Claims a free ring for the calling thread. Events a previous owner left behind stay in it
+// and are drained as usual, the head simply carries on from where they ended.
+//--------------------------------------------------
+static hdlc_log_ring_t *_hdlc_log_claim(void)
+{
+	for (int i = 0; i < HDLC_LOG_THREADS; i++) {
+		int expected = 0;
+
+		if (atomic_compare_exchange_strong(&_hdlc_log_rings[i].owned, &expected, 1)) {
+			_hdlc_log_ring = &_hdlc_log_rings[i];
+			return _hdlc_log_ring;
+		}
+	}
+
+	return NULL;
+}
+
+// Backs ERR: copies the arguments out by the conversions in fmt, which only holds %s and %d,
+// and leaves all formatting to the drain
+//--------------------------------------------------
+void _hdlc_log_record(const char *fmt, ...)
+{
+	hdlc_log_ring_t *ring = _hdlc_log_ring ? _hdlc_log_ring : _hdlc_log_claim();
+	if (ring == NULL) {
+		atomic_fetch_add_explicit(&_hdlc_log_dropped, 1, memory_order_relaxed);
+		return;
+	}
+
+	const unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	const unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	if (head - tail >= HDLC_LOG_RING_LEN) {
+		atomic_fetch_add_explicit(&_hdlc_log_dropped, 1, memory_order_relaxed);
+		return;
+	}
+
+	hdlc_log_event_t *event = &ring->events[head % HDLC_LOG_RING_LEN];
+	event->fmt = fmt;
+	event->count = 0;
+
+	va_list args;
+	va_start(args, fmt);
+
+	for (const char *p = fmt; *p != '\0' && event->count < HDLC_LOG_VALUES; p++) {
+		if (p[0] != '%' || p[1] == '\0') {
+			continue;
+		}
+
+		p++;
+
+		if (*p == 's') {
+			event->values[event->count++] = (uintptr_t)va_arg(args, const char *);
+		} else if (*p == 'd') {
+			event->values[event->count++] = (uint64_t)(int64_t)va_arg(args, int);
+		}
+	}
+
+	va_end(args);
+
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+//--------------------------------------------------
+int hdlc_log_drain(hdlc_log_cb_t cb, void *user)
+{
+	if (cb == NULL) {
+		return -1;
+	}
+
+	// A second drain at the same time would consume the same events
+	if (atomic_flag_test_and_set_explicit(&_hdlc_log_draining, memory_order_acquire)) {
+		return 0;
+	}
+
+	int drained = 0;
+
+	for (int i = 0; i < HDLC_LOG_THREADS; i++) {
+		hdlc_log_ring_t *ring = &_hdlc_log_rings[i];
+
+		const unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+		unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+		while (tail != head) {
+			cb(user, &ring->events[tail % HDLC_LOG_RING_LEN]);
+			atomic_store_explicit(&ring->tail, ++tail, memory_order_release);
+			drained++;
+		}
+	}
+
+	atomic_flag_clear_explicit(&_hdlc_log_draining, memory_order_release);
+
+	return drained;
+}
+
+//--------------------------------------------------
+uint32_t hdlc_log_dropped(void)
+{
+	return atomic_load_explicit(&_hdlc_log_dropped, memory_order_relaxed);
+}
+
+//--------------------------------------------------
+void hdlc_log_release(void)
+{
+	if (_hdlc_log_ring != NULL) {
+		atomic_store_explicit(&_hdlc_log_ring->owned, 0, memory_order_release);
+		_hdlc_log_ring = NULL;
+	}
+}
+
+#else
+
+//--------------------------------------------------
+int hdlc_log_drain(hdlc_log_cb_t cb, void *user)
+{
+	(void)cb;
+	(void)user;
+
+	return -1;
+}
+
+//--------------------------------------------------
+uint32_t hdlc_log_dropped(void)
+{
+	return 0;
+}
+
+//--------------------------------------------------
+void hdlc_log_release(void)
+{
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "hdlc.h"
+#include "hdlc_deframer.h"
+#include "hdlc_dispatch.h"
+#include "hdlc_fcs.h"
+#include "hdlc_log.h"
+#include "hdlc_probe.h"
+
+#include <string.h>
+
+// Strings passed to ERR are recorded by pointer and formatted later, only pass literals
+//--------------------------------------------------
+#ifdef HDLC_LOG_ENABLED
+#ifndef HDLC_LOG_THREADS
+#define HDLC_LOG_THREADS 8
+#endif
+#ifndef HDLC_LOG_RING_LEN
+#define HDLC_LOG_RING_LEN 64
+#endif
+void _hdlc_log_record(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+#define ERR(...) _hdlc_log_record(__VA_ARGS__)
+#else
+#define ERR(...)
+#endif
+
+//--------------------------------------------------
+#define HDLC_DELIMITER 0x7E
+#define HDLC_ESCAPE    0x7D
+#define HDLC_INVERTED  0x20
+
+//--------------------------------------------------
+#define CRC_POLY           0x1021
+#define CRC_POLY_REFLECTED 0x8408
+#define CRC_INIT           0xFFFF
+#define CRC_XOR_OUT        0xFFFF
+
+//--------------------------------------------------
+#define LOW_BYTE(x)  ((x) & 0xFF)
+#define HIGH_BYTE(x) (((x) >> 8) & 0xFF)
+
+// Timestamps stay zero without a clock
+//--------------------------------------------------
+static inline uint64_t _hdlc_now(hdlc_clock_t clock, void *user)
+{
+	return clock != NULL ? clock(user) : 0;
+}
+
+//--------------------------------------------------
+#if UINTPTR_MAX > 0xFFFFFFFF
+typedef uint64_t hdlc_word_t;
+#else
+typedef uint32_t hdlc_word_t;
+#endif
+
+#define HDLC_WORD_ONES  (~(hdlc_word_t)0 / 0xFF)
+#define HDLC_WORD_HIGHS (HDLC_WORD_ONES * 0x80)
+
+// Non zero when any byte of the word is zero
+//--------------------------------------------------
+static inline hdlc_word_t _hdlc_word_has_zero(hdlc_word_t word)
+{
+	return (word - HDLC_WORD_ONES) & ~word & HDLC_WORD_HIGHS;
+}
+
+// Length of the leading stretch without flag or escape bytes, checked a word at a time
+//--------------------------------------------------
+static inline size_t _hdlc_clean_run(const uint8_t *data, size_t len)
+{
+	size_t i = 0;
+
+#ifndef HDLC_PROFILE_SMALL
+	while (len - i >= sizeof(hdlc_word_t)) {
+		hdlc_word_t word;
+		memcpy(&word, data + i, sizeof(word));
+
+		if (_hdlc_word_has_zero(word ^ (HDLC_WORD_ONES * HDLC_DELIMITER)) |
+		    _hdlc_word_has_zero(word ^ (HDLC_WORD_ONES * HDLC_ESCAPE))) {
+			break;
+		}
+
+		i += sizeof(word);
+	}
+#endif
+
+	while (i < len && data[i] != HDLC_DELIMITER && data[i] != HDLC_ESCAPE) {
+		i++;
+	}
+
+	return i;
+}
+
+//--------------------------------------------------
+#define HDLC_FCS_LANES 4
+
+//--------------------------------------------------
+uint16_t _hdlc_fcs_update(uint16_t fcs, uint8_t byte);
+uint16_t _hdlc_fcs_update_block(uint16_t fcs, const uint8_t *data, size_t len);
+void _hdlc_fcs_update_lanes(uint16_t *fcs, const uint8_t *const *data, const size_t *len);
+uint16_t _hdlc_fcs_final(uint16_t fcs);
+uint16_t _hdlc_calculate_fcs(const uint8_t *data, int len);
+uint16_t _hdlc_fcs_shift(uint16_t delta, size_t len);
+
+//--------------------------------------------------
+int _hdlc_deframer_decode(hdlc_frame_t *frame, const uint8_t *data, int len);
+
+//--------------------------------------------------
+int _hdlc_patch_control(uint8_t *data, int len, int size, int tail_len, uint8_t control);
+
+//--------------------------------------------------
+#define HDLC_UNSTUFF_BLOCK 64
+
+typedef int (*hdlc_unstuff_fn_t)(const uint8_t *data, int len, uint8_t *out, int *out_len,
+				 uint8_t *tail_escaped);
+
+int _hdlc_unstuff_avx512(const uint8_t *data, int len, uint8_t *out, int *out_len,
+			 uint8_t *tail_escaped);
+int _hdlc_cpu_has_avx512_vbmi2(void);
+
+// Kernels bound by the dispatcher, a NULL entry leaves the work to the portable code
+//--------------------------------------------------
+typedef struct {
+	hdlc_unstuff_fn_t unstuff;
+} hdlc_kernels_t;
+
+extern const hdlc_kernels_t *_hdlc_active_kernels;
+
+void _hdlc_dispatch_probe(void);
+
+//--------------------------------------------------
+static inline const hdlc_kernels_t *_hdlc_kernels(void)
+{
+	const hdlc_kernels_t *kernels = __atomic_load_n(&_hdlc_active_kernels, __ATOMIC_ACQUIRE);
+
+	if (kernels == NULL) {
+		_hdlc_dispatch_probe();
+		kernels = __atomic_load_n(&_hdlc_active_kernels, __ATOMIC_ACQUIRE);
+	}
+
+	return kernels;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Static probes under the "hdlc" provider for perf and bpftrace, e.g.
+//   bpftrace -e 'usdt:./libhdlc.so:hdlc:fcs_error { @[arg1, arg2] = count(); }'
+//
+//   encode_start(frame, info_len)          decode_start(data, len)
+//   encode_done(frame, encoded_len, fcs)   decode_done(frame, result)
+//   frame_start(deframer)                  frame_done(deframer, info_len, encoded_len)
+//   fcs_error(deframer, fcs, received)     length_error(deframer, count)
+//   escape_error(deframer)                 abort(deframer)
+//
+// A probe is a single nop until a tracer attaches. Without HDLC_PROBES_ENABLED nothing is emitted.
+
+#ifdef HDLC_PROBES_ENABLED
+#include <sys/sdt.h>
+
+#define HDLC_PROBE1(name, a)       DTRACE_PROBE1(hdlc, name, a)
+#define HDLC_PROBE2(name, a, b)    DTRACE_PROBE2(hdlc, name, a, b)
+#define HDLC_PROBE3(name, a, b, c) DTRACE_PROBE3(hdlc, name, a, b, c)
+#else
+#define HDLC_PROBE1(name, a)       ((void)0)
+#define HDLC_PROBE2(name, a, b)    ((void)0)
+#define HDLC_PROBE3(name, a, b, c) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_retx.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+//--------------------------------------------------
+static int _hdlc_stuffed_len(uint8_t byte)
+{
+	return (byte == HDLC_DELIMITER || byte == HDLC_ESCAPE) ? 2 : 1;
+}
+
+//--------------------------------------------------
+int hdlc_retx_store_init(hdlc_retx_store_t *store)
+{
+	if (store == NULL) {
+		ERR("[%s:%d] store == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	for (int i = 0; i < HDLC_RETX_STORE_SLOTS; i++) {
+		store->entries[i].len = 0;
+		store->entries[i].valid = 0;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_retx_store_put(hdlc_retx_store_t *store, const hdlc_frame_t *frame)
+{
+	if (store == NULL || frame == NULL) {
+		ERR("[%s:%d] store == NULL || frame == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	hdlc_retx_entry_t *entry = &store->entries[frame->control.i_fields.ns];
+
+	const int result = hdlc_encode(frame, entry->data, sizeof(entry->data));
+	if (result < 0) {
+		ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+		entry->valid = 0;
+		return -1;
+	}
+
+	// Remember the stuffed size of the information field so the FCS can be patched later
+	int tail_len = 0;
+	for (int i = 0; i < frame->info_len; i++) {
+		tail_len += _hdlc_stuffed_len(frame->info[i]);
+	}
+
+	entry->len = result;
+	entry->tail_len = tail_len;
+	entry->control = frame->control.value;
+	entry->valid = 1;
+
+	return result;
+}
+
+//--------------------------------------------------
+int hdlc_retx_store_get(hdlc_retx_store_t *store, uint8_t ns, const hdlc_control_t *control,
+			uint8_t *data, int len)
+{
+	if (store == NULL || data == NULL) {
+		ERR("[%s:%d] store == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (ns >= HDLC_RETX_STORE_SLOTS || !store->entries[ns].valid) {
+		ERR("[%s:%d] No frame stored for N(S)\n", __func__, __LINE__);
+		return -1;
+	}
+
+	hdlc_retx_entry_t *entry = &store->entries[ns];
+
+	// Only touch the stored copy when N(R) or P/F changed since the last transmission
+	if (control != NULL && control->value != entry->control) {
+		const int result = _hdlc_patch_control(entry->data, entry->len, sizeof(entry->data),
+						       entry->tail_len, control->value);
+		if (result < 0) {
+			ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+			return -1;
+		}
+
+		entry->len = result;
+		entry->control = control->value;
+	}
+
+	if (entry->len > len) {
+		ERR("[%s:%d] entry->len > len\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memcpy(data, entry->data, entry->len);
+
+	return entry->len;
+}
+
+//--------------------------------------------------
+int hdlc_retx_store_release(hdlc_retx_store_t *store, uint8_t ns)
+{
+	if (store == NULL) {
+		ERR("[%s:%d] store == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (ns >= HDLC_RETX_STORE_SLOTS) {
+		ERR("[%s:%d] ns >= HDLC_RETX_STORE_SLOTS\n", __func__, __LINE__);
+		return -1;
+	}
+
+	store->entries[ns].valid = 0;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_retx_store_contains(const hdlc_retx_store_t *store, uint8_t ns)
+{
+	if (store == NULL) {
+		ERR("[%s:%d] store == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (ns >= HDLC_RETX_STORE_SLOTS) {
+		return 0;
+	}
+
+	return store->entries[ns].valid;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_rtt.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+#define HDLC_RTT_SEQUENCE_MASK (HDLC_RTT_SEQUENCE_COUNT - 1)
+
+//--------------------------------------------------
+static hdlc_tick_t _hdlc_rtt_clamp(const hdlc_rtt_t *rtt, uint64_t rto)
+{
+	if (rto < rtt->min_rto) {
+		return rtt->min_rto;
+	}
+
+	if (rto > rtt->max_rto) {
+		return rtt->max_rto;
+	}
+
+	return (hdlc_tick_t)rto;
+}
+
+//--------------------------------------------------
+int hdlc_rtt_init(hdlc_rtt_t *rtt, hdlc_tick_t initial_rto, hdlc_tick_t min_rto,
+		  hdlc_tick_t max_rto)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (min_rto == 0 || min_rto > max_rto) {
+		ERR("[%s:%d] Invalid RTO bounds\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(rtt, 0, sizeof(*rtt));
+
+	rtt->min_rto = min_rto;
+	rtt->max_rto = max_rto;
+	rtt->rto = _hdlc_rtt_clamp(rtt, initial_rto);
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_rtt_on_send(hdlc_rtt_t *rtt, uint8_t ns, hdlc_tick_t now)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	const uint8_t bit = 1 << (ns & HDLC_RTT_SEQUENCE_MASK);
+
+	// The ack of a retransmitted frame is ambiguous, never time it
+	if (rtt->outstanding & bit) {
+		rtt->retransmitted |= bit;
+		return 0;
+	}
+
+	rtt->outstanding |= bit;
+	rtt->retransmitted &= ~bit;
+	rtt->sent_at[ns & HDLC_RTT_SEQUENCE_MASK] = now;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_rtt_on_ack(hdlc_rtt_t *rtt, uint8_t nr, hdlc_tick_t now)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	int acked = 0;
+	int sampled = 0;
+
+	// N(R) acknowledges everything before it, newest first so that frame gives the sample
+	for (int i = 1; i < HDLC_RTT_SEQUENCE_COUNT; i++) {
+		const uint8_t ns = (nr - i) & HDLC_RTT_SEQUENCE_MASK;
+		const uint8_t bit = 1 << ns;
+
+		if (!(rtt->outstanding & bit)) {
+			break;
+		}
+
+		if (!sampled && !(rtt->retransmitted & bit)) {
+			hdlc_rtt_sample(rtt, now - rtt->sent_at[ns]);
+			sampled = 1;
+		}
+
+		rtt->outstanding &= ~bit;
+		rtt->retransmitted &= ~bit;
+		acked++;
+	}
+
+	return acked;
+}
+
+//--------------------------------------------------
+int hdlc_rtt_on_timeout(hdlc_rtt_t *rtt)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// Exponential backoff until a clean sample comes back
+	if (((uint64_t)rtt->rto << rtt->backoff) < rtt->max_rto) {
+		rtt->backoff++;
+	}
+
+	return 0;
+}
+
+// RFC 6298 in fixed point: SRTT += (R - SRTT) / 8, RTTVAR += (|R - SRTT| - RTTVAR) / 4
+//--------------------------------------------------
+int hdlc_rtt_sample(hdlc_rtt_t *rtt, hdlc_tick_t sample)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (!rtt->has_sample) {
+		rtt->srtt = sample << 3;
+		rtt->rttvar = sample << 1;
+		rtt->has_sample = 1;
+	} else {
+		int64_t error = (int64_t)sample - (rtt->srtt >> 3);
+
+		rtt->srtt += error;
+		if (error < 0) {
+			error = -error;
+		}
+
+		rtt->rttvar += error - (rtt->rttvar >> 2);
+	}
+
+	// The variance term is at least one tick so RTO stays above SRTT
+	const uint32_t variance = rtt->rttvar > 0 ? rtt->rttvar : 1;
+
+	rtt->rto = _hdlc_rtt_clamp(rtt, (uint64_t)(rtt->srtt >> 3) + variance);
+	rtt->backoff = 0;
+
+	return 0;
+}
+
+//--------------------------------------------------
+hdlc_tick_t hdlc_rtt_rto(const hdlc_rtt_t *rtt)
+{
+	if (rtt == NULL) {
+		ERR("[%s:%d] rtt == NULL\n", __func__, __LINE__);
+		return 0;
+	}
+
+	return _hdlc_rtt_clamp(rtt, (uint64_t)rtt->rto << rtt->backoff);
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_timer.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+#define HDLC_TIMER_WHEEL_MASK (HDLC_TIMER_WHEEL_SLOTS - 1)
+
+// Level n holds the timers that expire within 64^(n + 1) ticks, indexed by the n-th group of six
+// bits of their expiry. Whenever the lower levels wrap, the matching slot of the level above is
+// cascaded down, so every timer is touched at most once per level.
+
+//--------------------------------------------------
+static void _hdlc_timer_link(hdlc_timer_t **head, hdlc_timer_t *timer)
+{
+	timer->next = *head;
+	if (timer->next != NULL) {
+		timer->next->pprev = &timer->next;
+	}
+
+	*head = timer;
+	timer->pprev = head;
+}
+
+//--------------------------------------------------
+static void _hdlc_timer_unlink(hdlc_timer_t *timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next != NULL) {
+		timer->next->pprev = timer->pprev;
+	}
+
+	timer->next = NULL;
+	timer->pprev = NULL;
+}
+
+//--------------------------------------------------
+static void _hdlc_timer_wheel_add(hdlc_timer_wheel_t *wheel, hdlc_timer_t *timer)
+{
+	const hdlc_tick_t delta = timer->expires - wheel->tick;
+
+	// Already due, run it on the next tick
+	if ((int32_t)delta < 0) {
+		_hdlc_timer_link(&wheel->slots[0][wheel->tick & HDLC_TIMER_WHEEL_MASK], timer);
+		return;
+	}
+
+	for (int level = 0; level < HDLC_TIMER_WHEEL_LEVELS; level++) {
+		const int shift = HDLC_TIMER_WHEEL_BITS * level;
+
+		if ((uint64_t)delta < ((uint64_t)1 << (shift + HDLC_TIMER_WHEEL_BITS))) {
+			const int index = (timer->expires >> shift) & HDLC_TIMER_WHEEL_MASK;
+
+			_hdlc_timer_link(&wheel->slots[level][index], timer);
+			return;
+		}
+	}
+}
+
+//--------------------------------------------------
+static void _hdlc_timer_wheel_cascade(hdlc_timer_wheel_t *wheel)
+{
+	for (int level = 1; level < HDLC_TIMER_WHEEL_LEVELS; level++) {
+		const int index = (wheel->tick >> (HDLC_TIMER_WHEEL_BITS * level)) & HDLC_TIMER_WHEEL_MASK;
+
+		hdlc_timer_t *timer = wheel->slots[level][index];
+		wheel->slots[level][index] = NULL;
+
+		while (timer != NULL) {
+			hdlc_timer_t *next = timer->next;
+
+			_hdlc_timer_wheel_add(wheel, timer);
+			timer = next;
+		}
+
+		// Only carry on upwards when this level wrapped as well
+		if (index != 0) {
+			break;
+		}
+	}
+}
+
+//--------------------------------------------------
+int hdlc_timer_wheel_init(hdlc_timer_wheel_t *wheel, hdlc_tick_t now)
+{
+	if (wheel == NULL) {
+		ERR("[%s:%d] wheel == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(wheel, 0, sizeof(*wheel));
+
+	// The wheel keeps the next tick to process
+	wheel->tick = now + 1;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_timer_wheel_advance(hdlc_timer_wheel_t *wheel, hdlc_tick_t now)
+{
+	if (wheel == NULL) {
+		ERR("[%s:%d] wheel == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	int fired = 0;
+
+	while ((int32_t)(now - wheel->tick) >= 0) {
+		// Nothing can expire, jump straight to the present
+		if (wheel->active == 0) {
+			wheel->tick = now + 1;
+			break;
+		}
+
+		const int index = wheel->tick & HDLC_TIMER_WHEEL_MASK;
+
+		if (index == 0) {
+			_hdlc_timer_wheel_cascade(wheel);
+		}
+
+		wheel->tick++;
+
+		// A callback may restart a timer for a full turn of the wheel, which lands in this very
+		// slot, so the due timers are moved to a local list first
+		hdlc_timer_t *due = wheel->slots[0][index];
+		wheel->slots[0][index] = NULL;
+
+		if (due != NULL) {
+			due->pprev = &due;
+		}
+
+		while (due != NULL) {
+			hdlc_timer_t *timer = due;
+
+			_hdlc_timer_unlink(timer);
+			wheel->active--;
+			fired++;
+
+			if (timer->cb != NULL) {
+				timer->cb(timer->user, timer);
+			}
+		}
+	}
+
+	return fired;
+}
+
+//--------------------------------------------------
+int hdlc_timer_init(hdlc_timer_t *timer, hdlc_timer_cb_t cb, void *user)
+{
+	if (timer == NULL) {
+		ERR("[%s:%d] timer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(timer, 0, sizeof(*timer));
+
+	timer->cb = cb;
+	timer->user = user;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_timer_start(hdlc_timer_wheel_t *wheel, hdlc_timer_t *timer, hdlc_tick_t timeout)
+{
+	if (wheel == NULL || timer == NULL) {
+		ERR("[%s:%d] wheel == NULL || timer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (timer->pprev != NULL) {
+		_hdlc_timer_unlink(timer);
+		wheel->active--;
+	}
+
+	if (timeout > HDLC_TIMER_MAX_TIMEOUT) {
+		timeout = HDLC_TIMER_MAX_TIMEOUT;
+	}
+
+	// Relative to the last processed tick
+	timer->expires = wheel->tick - 1 + timeout;
+
+	_hdlc_timer_wheel_add(wheel, timer);
+	wheel->active++;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_timer_cancel(hdlc_timer_wheel_t *wheel, hdlc_timer_t *timer)
+{
+	if (wheel == NULL || timer == NULL) {
+		ERR("[%s:%d] wheel == NULL || timer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (timer->pprev == NULL) {
+		return 0;
+	}
+
+	_hdlc_timer_unlink(timer);
+	wheel->active--;
+
+	return 1;
+}
+
+//--------------------------------------------------
+int hdlc_timer_active(const hdlc_timer_t *timer)
+{
+	if (timer == NULL) {
+		ERR("[%s:%d] timer == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return timer->pprev != NULL;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_tx.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+//--------------------------------------------------
+static int _hdlc_tx_should_preempt(const hdlc_tx_t *tx)
+{
+	const hdlc_tx_class_t *cls = &tx->sched->classes[tx->current->class_id];
+
+	// Strict frames are never interrupted, neither is a frame that has not started yet
+	if (cls->mode != HDLC_TX_CLASS_WEIGHTED || !hdlc_encoder_started(&tx->encoder)) {
+		return 0;
+	}
+
+	if (hdlc_encoder_remaining(&tx->encoder) < HDLC_TX_PREEMPT_MIN_REMAINING) {
+		return 0;
+	}
+
+	return hdlc_tx_sched_strict_pending(tx->sched) > 0;
+}
+
+//--------------------------------------------------
+static int _hdlc_tx_abort(hdlc_tx_t *tx, uint8_t *data, int len)
+{
+	const int result = hdlc_encoder_abort(&tx->encoder, data, len);
+	if (result < 0) {
+		ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (hdlc_tx_sched_requeue(tx->sched, tx->current) < 0) {
+		ERR("[%s:%d] Requeue failed\n", __func__, __LINE__);
+		return -1;
+	}
+
+	tx->current = NULL;
+	tx->aborts++;
+
+	return result;
+}
+
+//--------------------------------------------------
+int hdlc_tx_init(hdlc_tx_t *tx, hdlc_tx_sched_t *sched, hdlc_tx_sent_cb_t sent_cb, void *user)
+{
+	if (tx == NULL || sched == NULL) {
+		ERR("[%s:%d] tx == NULL || sched == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(tx, 0, sizeof(*tx));
+
+	tx->sched = sched;
+	tx->sent_cb = sent_cb;
+	tx->user = user;
+
+	return 0;
+}
+
+// Every frame pulled from then on is timestamped, the sent callback finds the times of the
+// frame it is called for in the encoder
+//--------------------------------------------------
+int hdlc_tx_set_clock(hdlc_tx_t *tx, hdlc_clock_t clock, void *user)
+{
+	if (tx == NULL) {
+		ERR("[%s:%d] tx == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	tx->clock = clock;
+	tx->clock_user = user;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_pull(hdlc_tx_t *tx, uint8_t *data, int len)
+{
+	if (tx == NULL || data == NULL) {
+		ERR("[%s:%d] tx == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	int written = 0;
+
+	while (written < len) {
+		// The flag of an abort that did not fit into the previous pull goes out first
+		if (tx->current == NULL && !hdlc_encoder_done(&tx->encoder)) {
+			const int result =
+				hdlc_encoder_pull(&tx->encoder, data + written, len - written);
+			if (result < 0) {
+				ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+				return -1;
+			}
+
+			written += result;
+			continue;
+		}
+
+		if (tx->current == NULL) {
+			hdlc_tx_item_t *item = hdlc_tx_sched_dequeue(tx->sched);
+			if (item == NULL) {
+				break;
+			}
+
+			if (hdlc_encoder_init(&tx->encoder, item->frame) < 0) {
+				ERR("[%s:%d] Encoder init failed\n", __func__, __LINE__);
+				return -1;
+			}
+
+			hdlc_encoder_set_clock(&tx->encoder, tx->clock, tx->clock_user);
+
+			tx->current = item;
+		}
+
+		if (_hdlc_tx_should_preempt(tx)) {
+			const int result = _hdlc_tx_abort(tx, data + written, len - written);
+			if (result < 0) {
+				ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+				return -1;
+			}
+
+			written += result;
+			continue;
+		}
+
+		const int result = hdlc_encoder_pull(&tx->encoder, data + written, len - written);
+		if (result < 0) {
+			ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+			return -1;
+		}
+
+		written += result;
+
+		if (hdlc_encoder_done(&tx->encoder)) {
+			hdlc_tx_item_t *item = tx->current;
+
+			tx->current = NULL;
+
+			if (tx->sent_cb != NULL) {
+				tx->sent_cb(tx->user, item);
+			}
+		}
+	}
+
+	return written;
+}
+
+//--------------------------------------------------
+int hdlc_tx_busy(const hdlc_tx_t *tx)
+{
+	if (tx == NULL) {
+		ERR("[%s:%d] tx == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return tx->current != NULL || !hdlc_encoder_done(&tx->encoder) ||
+	       hdlc_tx_sched_pending(tx->sched) > 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_tx_pipeline.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+// Buffers form a ring: [send, send + ready) are closed and waiting for or on the wire, fill is the
+// one being filled and the rest are free. The service side only moves fill and raises ready, the
+// completion side only moves send and lowers ready, and starting a transfer needs in_flight to be
+// claimed first, so the two sides never write the same index.
+
+//--------------------------------------------------
+static uint8_t _hdlc_tx_pipeline_next(const hdlc_tx_pipeline_t *pipeline, uint8_t index)
+{
+	return (uint8_t)((index + 1) % pipeline->count);
+}
+
+//--------------------------------------------------
+static uint8_t _hdlc_tx_pipeline_ready(const hdlc_tx_pipeline_t *pipeline)
+{
+	return __atomic_load_n(&pipeline->ready, __ATOMIC_ACQUIRE);
+}
+
+//--------------------------------------------------
+static uint8_t _hdlc_tx_pipeline_in_flight(const hdlc_tx_pipeline_t *pipeline)
+{
+	return __atomic_load_n(&pipeline->in_flight, __ATOMIC_ACQUIRE);
+}
+
+//--------------------------------------------------
+static int _hdlc_tx_pipeline_kick(hdlc_tx_pipeline_t *pipeline)
+{
+	while (_hdlc_tx_pipeline_ready(pipeline) > 0) {
+		uint8_t expected = 0;
+
+		// The other side owns the link and kicks again once its transfer completes
+		if (!__atomic_compare_exchange_n(&pipeline->in_flight, &expected, 1, 0, __ATOMIC_ACQ_REL,
+						 __ATOMIC_ACQUIRE)) {
+			return 0;
+		}
+
+		// Completed in between, give the link back and look again so a buffer closed meanwhile
+		// is not left waiting
+		if (_hdlc_tx_pipeline_ready(pipeline) == 0) {
+			__atomic_store_n(&pipeline->in_flight, 0, __ATOMIC_RELEASE);
+			continue;
+		}
+
+		const uint8_t index = pipeline->send;
+
+		if (pipeline->start(pipeline->user, pipeline->buffers[index], pipeline->lens[index]) <
+		    0) {
+			ERR("[%s:%d] Transfer start failed\n", __func__, __LINE__);
+			__atomic_store_n(&pipeline->in_flight, 0, __ATOMIC_RELEASE);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_pipeline_init(hdlc_tx_pipeline_t *pipeline, uint8_t *storage, int buffer_size,
+			  uint8_t buffer_count, hdlc_tx_pipeline_source_t source,
+			  hdlc_tx_pipeline_start_t start, void *user)
+{
+	if (pipeline == NULL || storage == NULL || source == NULL || start == NULL) {
+		ERR("[%s:%d] pipeline == NULL || storage == NULL || source == NULL || start == NULL\n",
+		    __func__, __LINE__);
+		return -1;
+	}
+
+	if (buffer_count < 2 || buffer_count > HDLC_TX_PIPELINE_MAX_BUFFERS) {
+		ERR("[%s:%d] Invalid buffer count\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (buffer_size <= 0 || (buffer_size % HDLC_TX_PIPELINE_ALIGN) != 0 ||
+	    ((uintptr_t)storage % HDLC_TX_PIPELINE_ALIGN) != 0) {
+		ERR("[%s:%d] Buffers are not aligned\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(pipeline, 0, sizeof(*pipeline));
+
+	for (uint8_t i = 0; i < buffer_count; i++) {
+		pipeline->buffers[i] = storage + (size_t)i * buffer_size;
+	}
+
+	pipeline->size = buffer_size;
+	pipeline->count = buffer_count;
+	pipeline->source = source;
+	pipeline->start = start;
+	pipeline->user = user;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_pipeline_service(hdlc_tx_pipeline_t *pipeline)
+{
+	if (pipeline == NULL) {
+		ERR("[%s:%d] pipeline == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// Encode ahead into every buffer that is not closed yet
+	while (_hdlc_tx_pipeline_ready(pipeline) < pipeline->count) {
+		const uint8_t index = pipeline->fill;
+		uint8_t *data = pipeline->buffers[index] + pipeline->lens[index];
+		const int room = pipeline->size - pipeline->lens[index];
+
+		const int result = pipeline->source(pipeline->user, data, room);
+		if (result < 0) {
+			ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+			return -1;
+		}
+
+		pipeline->lens[index] += result;
+
+		if (pipeline->lens[index] < pipeline->size) {
+			// The source ran dry, only hand over a partial buffer when the link would idle
+			if (pipeline->lens[index] == 0 || _hdlc_tx_pipeline_in_flight(pipeline) ||
+			    _hdlc_tx_pipeline_ready(pipeline) > 0) {
+				break;
+			}
+		}
+
+		pipeline->fill = _hdlc_tx_pipeline_next(pipeline, index);
+		__atomic_fetch_add(&pipeline->ready, 1, __ATOMIC_RELEASE);
+
+		if (pipeline->lens[index] < pipeline->size) {
+			break;
+		}
+	}
+
+	return _hdlc_tx_pipeline_kick(pipeline);
+}
+
+//--------------------------------------------------
+int hdlc_tx_pipeline_complete(hdlc_tx_pipeline_t *pipeline)
+{
+	if (pipeline == NULL) {
+		ERR("[%s:%d] pipeline == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (!_hdlc_tx_pipeline_in_flight(pipeline)) {
+		ERR("[%s:%d] No transfer in flight\n", __func__, __LINE__);
+		return -1;
+	}
+
+	// The buffer is emptied before it is released to the service side for refilling
+	pipeline->lens[pipeline->send] = 0;
+	pipeline->send = _hdlc_tx_pipeline_next(pipeline, pipeline->send);
+	__atomic_fetch_sub(&pipeline->ready, 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&pipeline->in_flight, 0, __ATOMIC_RELEASE);
+
+	// Swap straight to the next closed buffer so the link keeps going
+	return _hdlc_tx_pipeline_kick(pipeline);
+}
+
+//--------------------------------------------------
+int hdlc_tx_pipeline_idle(const hdlc_tx_pipeline_t *pipeline)
+{
+	if (pipeline == NULL) {
+		ERR("[%s:%d] pipeline == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return !_hdlc_tx_pipeline_in_flight(pipeline) && _hdlc_tx_pipeline_ready(pipeline) == 0 &&
+	       pipeline->lens[pipeline->fill] == 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_tx_sched.h"
+#include "hdlc_private.h"
+
+#include <string.h>
+
+//--------------------------------------------------
+static uint32_t _hdlc_tx_sched_cost(const hdlc_frame_t *frame)
+{
+	// Address, control and FCS plus the information field
+	return (uint32_t)frame->info_len + 4;
+}
+
+// Returns the class that is allowed to send next or -1 if nothing is pending
+//--------------------------------------------------
+static int _hdlc_tx_sched_select(hdlc_tx_sched_t *sched)
+{
+	int weighted_pending = 0;
+
+	// Strict classes always go first, lowest class id wins
+	for (uint8_t i = 0; i < sched->class_count; i++) {
+		const hdlc_tx_class_t *cls = &sched->classes[i];
+
+		if (cls->head == NULL) {
+			continue;
+		}
+
+		if (cls->mode == HDLC_TX_CLASS_STRICT) {
+			return i;
+		}
+
+		weighted_pending = 1;
+	}
+
+	if (!weighted_pending) {
+		return -1;
+	}
+
+	// Deficit round robin over the weighted classes, every visit adds a quantum so this
+	// terminates once the head frame of some class fits in its deficit
+	for (;;) {
+		hdlc_tx_class_t *cls = &sched->classes[sched->current];
+
+		if (cls->mode == HDLC_TX_CLASS_WEIGHTED && cls->head != NULL) {
+			if (!cls->credited) {
+				cls->deficit += cls->quantum;
+				cls->credited = 1;
+			}
+
+			if (_hdlc_tx_sched_cost(cls->head->frame) <= cls->deficit) {
+				return sched->current;
+			}
+
+			cls->credited = 0;
+		}
+
+		sched->current = (sched->current + 1) % sched->class_count;
+	}
+}
+
+//--------------------------------------------------
+static hdlc_tx_item_t *_hdlc_tx_sched_pop(hdlc_tx_sched_t *sched, uint8_t class_id)
+{
+	hdlc_tx_class_t *cls = &sched->classes[class_id];
+	hdlc_tx_item_t *item = cls->head;
+
+	cls->head = item->next;
+	if (cls->head == NULL) {
+		cls->tail = NULL;
+	}
+
+	item->next = NULL;
+	sched->pending--;
+
+	if (cls->mode == HDLC_TX_CLASS_WEIGHTED) {
+		cls->deficit -= _hdlc_tx_sched_cost(item->frame);
+
+		// An idle class must not hoard credit, and hands the turn to the next class
+		if (cls->head == NULL) {
+			cls->deficit = 0;
+			cls->credited = 0;
+			sched->current = (sched->current + 1) % sched->class_count;
+		}
+	}
+
+	return item;
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_init(hdlc_tx_sched_t *sched, const hdlc_tx_class_config_t *config,
+		       uint8_t class_count)
+{
+	if (sched == NULL || config == NULL) {
+		ERR("[%s:%d] sched == NULL || config == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (class_count == 0 || class_count > HDLC_TX_SCHED_CLASS_COUNT) {
+		ERR("[%s:%d] Invalid class count\n", __func__, __LINE__);
+		return -1;
+	}
+
+	memset(sched, 0, sizeof(*sched));
+
+	for (uint8_t i = 0; i < class_count; i++) {
+		if (config[i].mode == HDLC_TX_CLASS_WEIGHTED && config[i].weight == 0) {
+			ERR("[%s:%d] Weighted class without weight\n", __func__, __LINE__);
+			return -1;
+		}
+
+		sched->classes[i].mode = config[i].mode;
+		sched->classes[i].quantum = (uint32_t)config[i].weight * HDLC_TX_SCHED_QUANTUM;
+	}
+
+	sched->class_count = class_count;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_enqueue(hdlc_tx_sched_t *sched, hdlc_tx_item_t *item, const hdlc_frame_t *frame,
+			  uint8_t class_id)
+{
+	if (sched == NULL || item == NULL || frame == NULL) {
+		ERR("[%s:%d] sched == NULL || item == NULL || frame == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (class_id >= sched->class_count) {
+		ERR("[%s:%d] Unknown class\n", __func__, __LINE__);
+		return -1;
+	}
+
+	hdlc_tx_class_t *cls = &sched->classes[class_id];
+
+	item->next = NULL;
+	item->frame = frame;
+	item->class_id = class_id;
+
+	if (cls->tail != NULL) {
+		cls->tail->next = item;
+	} else {
+		cls->head = item;
+	}
+
+	cls->tail = item;
+	sched->pending++;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_requeue(hdlc_tx_sched_t *sched, hdlc_tx_item_t *item)
+{
+	if (sched == NULL || item == NULL || item->frame == NULL) {
+		ERR("[%s:%d] sched == NULL || item == NULL || item->frame == NULL\n", __func__,
+		    __LINE__);
+		return -1;
+	}
+
+	if (item->class_id >= sched->class_count) {
+		ERR("[%s:%d] Unknown class\n", __func__, __LINE__);
+		return -1;
+	}
+
+	hdlc_tx_class_t *cls = &sched->classes[item->class_id];
+
+	// Put the frame back in front of its class
+	item->next = cls->head;
+	cls->head = item;
+	if (cls->tail == NULL) {
+		cls->tail = item;
+	}
+
+	sched->pending++;
+
+	// Refund what the interrupted transmission was charged
+	if (cls->mode == HDLC_TX_CLASS_WEIGHTED) {
+		cls->deficit += _hdlc_tx_sched_cost(item->frame);
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+hdlc_tx_item_t *hdlc_tx_sched_dequeue(hdlc_tx_sched_t *sched)
+{
+	if (sched == NULL) {
+		ERR("[%s:%d] sched == NULL\n", __func__, __LINE__);
+		return NULL;
+	}
+
+	const int class_id = _hdlc_tx_sched_select(sched);
+	if (class_id < 0) {
+		return NULL;
+	}
+
+	return _hdlc_tx_sched_pop(sched, (uint8_t)class_id);
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_pending(const hdlc_tx_sched_t *sched)
+{
+	if (sched == NULL) {
+		ERR("[%s:%d] sched == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return sched->pending;
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_strict_pending(const hdlc_tx_sched_t *sched)
+{
+	if (sched == NULL) {
+		ERR("[%s:%d] sched == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	for (uint8_t i = 0; i < sched->class_count; i++) {
+		const hdlc_tx_class_t *cls = &sched->classes[i];
+
+		if (cls->mode == HDLC_TX_CLASS_STRICT && cls->head != NULL) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_tx_sched_encode(hdlc_tx_sched_t *sched, uint8_t *data, int len)
+{
+	if (sched == NULL || data == NULL) {
+		ERR("[%s:%d] sched == NULL || data == NULL\n", __func__, __LINE__);
+		return -1;
+	}
+
+	const int class_id = _hdlc_tx_sched_select(sched);
+	if (class_id < 0) {
+		return 0;
+	}
+
+	// Only take the frame off the queue once it is encoded, so a short buffer loses nothing
+	const int result = hdlc_encode(sched->classes[class_id].head->frame, data, len);
+	if (result < 0) {
+		ERR("[%s:%d] result < 0\n", __func__, __LINE__);
+		return -1;
+	}
+
+	_hdlc_tx_sched_pop(sched, (uint8_t)class_id);
+
+	return result;
+}
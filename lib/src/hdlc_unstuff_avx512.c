@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_private.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(HDLC_PROFILE_SMALL)
+
+#include <immintrin.h>
+
+#define HDLC_AVX512_TARGET __attribute__((target("avx512f,avx512bw,avx512vbmi2,bmi,popcnt")))
+
+// Unstuffs one 64 byte block from inside a frame: escapes are dropped with VPCOMPRESSB after
+// their successors had 0x20 XORed back. Stops before the first flag and before an escape that
+// ends the block. Anything unusual (an escape after an escape, fewer than three bytes) is left
+// to the table by returning 0.
+//--------------------------------------------------
+HDLC_AVX512_TARGET
+int _hdlc_unstuff_avx512(const uint8_t *data, int len, uint8_t *out, int *out_len,
+			 uint8_t *tail_escaped)
+{
+	if (len < HDLC_UNSTUFF_BLOCK) {
+		return 0;
+	}
+
+	const __m512i bytes = _mm512_loadu_si512(data);
+	const uint64_t flags = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8(HDLC_DELIMITER));
+
+	int used = flags ? (int)_tzcnt_u64(flags) : HDLC_UNSTUFF_BLOCK;
+	if (used < 3) {
+		return 0;
+	}
+
+	uint64_t valid = used == HDLC_UNSTUFF_BLOCK ? ~0ULL : (1ULL << used) - 1;
+	uint64_t escapes = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8(HDLC_ESCAPE)) & valid;
+
+	// Checked before the trim below, which would otherwise hide an escape pair at the very end
+	if (escapes & (escapes << 1)) {
+		return 0;
+	}
+
+	// The partner of a trailing escape is in the next block, or it is an abort
+	if ((escapes >> (used - 1)) & 1) {
+		used--;
+		valid >>= 1;
+		escapes &= valid;
+	}
+
+	const __m512i unescaped = _mm512_mask_blend_epi8(
+		escapes << 1, bytes, _mm512_xor_si512(bytes, _mm512_set1_epi8(HDLC_INVERTED)));
+
+	const uint64_t keep = valid & ~escapes;
+	const int count = (int)_mm_popcnt_u64(keep);
+	if (count < 3) {
+		return 0;
+	}
+
+	_mm512_storeu_si512(out, _mm512_maskz_compress_epi8(keep, unescaped));
+	*out_len = count;
+
+	// Whether the last two bytes came in escaped, as the FCS delay line needs to know
+	const uint8_t last = (escapes >> (used - 2)) & 1;
+	const int previous_end = used - 2 - last;
+	const uint8_t previous = previous_end >= 1 ? (escapes >> (previous_end - 1)) & 1 : 0;
+
+	*tail_escaped = previous | last << 1;
+
+	return used;
+}
+
+//--------------------------------------------------
+int _hdlc_cpu_has_avx512_vbmi2(void)
+{
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi2");
+}
+
+#else
+
+//--------------------------------------------------
+int _hdlc_unstuff_avx512(const uint8_t *data, int len, uint8_t *out, int *out_len,
+			 uint8_t *tail_escaped)
+{
+	(void)data;
+	(void)len;
+	(void)out;
+	(void)out_len;
+	(void)tail_escaped;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int _hdlc_cpu_has_avx512_vbmi2(void)
+{
+	return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HDLC_SIM_CHANNEL_CAPACITY
+#define HDLC_SIM_CHANNEL_CAPACITY 65536
+#endif
+
+#if (HDLC_SIM_CHANNEL_CAPACITY & (HDLC_SIM_CHANNEL_CAPACITY - 1)) != 0
+#error "HDLC_SIM_CHANNEL_CAPACITY must be a power of two"
+#endif
+
+// All times are in nanoseconds on a clock chosen by the caller
+typedef uint64_t hdlc_sim_time_t;
+
+typedef struct {
+	uint64_t seed;
+	double bit_error_rate;   // Probability that a bit is flipped
+	double drop_rate;        // Probability that a byte is lost
+	double flag_insert_rate; // Probability that a spurious flag is inserted before a byte
+	hdlc_sim_time_t latency;
+	uint64_t bandwidth; // Bits per second, 0 for unlimited
+} hdlc_sim_config_t;
+
+typedef struct {
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+	uint64_t bit_errors;
+	uint64_t drops;
+	uint64_t inserted_flags;
+	uint64_t overflows;
+} hdlc_sim_stats_t;
+
+typedef struct {
+	hdlc_sim_config_t config;
+	hdlc_sim_stats_t stats;
+	uint64_t rng;
+	uint64_t bits_to_error;
+	hdlc_sim_time_t byte_time;
+	hdlc_sim_time_t link_free_at;
+	uint32_t head;
+	uint32_t tail;
+	uint8_t data[HDLC_SIM_CHANNEL_CAPACITY];
+	hdlc_sim_time_t deliver_at[HDLC_SIM_CHANNEL_CAPACITY];
+} hdlc_sim_channel_t;
+
+int hdlc_sim_channel_init(hdlc_sim_channel_t *channel, const hdlc_sim_config_t *config);
+int hdlc_sim_channel_write(hdlc_sim_channel_t *channel, hdlc_sim_time_t now, const uint8_t *data,
+			   int len);
+int hdlc_sim_channel_read(hdlc_sim_channel_t *channel, hdlc_sim_time_t now, uint8_t *data,
+			  int len);
+int hdlc_sim_channel_next_delivery(const hdlc_sim_channel_t *channel, hdlc_sim_time_t *time);
+int hdlc_sim_channel_pending(const hdlc_sim_channel_t *channel);
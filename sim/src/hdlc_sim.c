@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2025, Open Pixel Systems
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlc_sim.h"
+
+#include <math.h>
+#include <string.h>
+
+//--------------------------------------------------
+#define HDLC_SIM_FLAG         0x7E
+#define HDLC_SIM_CHANNEL_MASK (HDLC_SIM_CHANNEL_CAPACITY - 1)
+#define NSEC_PER_SEC          1000000000ULL
+
+//--------------------------------------------------
+static uint64_t _hdlc_sim_next(hdlc_sim_channel_t *channel)
+{
+	// splitmix64, deterministic for a given seed
+	uint64_t z = (channel->rng += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1]
+//--------------------------------------------------
+static double _hdlc_sim_uniform(hdlc_sim_channel_t *channel)
+{
+	return ((_hdlc_sim_next(channel) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+//--------------------------------------------------
+static int _hdlc_sim_chance(hdlc_sim_channel_t *channel, double probability)
+{
+	return probability > 0.0 && _hdlc_sim_uniform(channel) <= probability;
+}
+
+// Distance to the next bit error, drawn from the geometric distribution so clean bits cost nothing
+//--------------------------------------------------
+static uint64_t _hdlc_sim_error_gap(hdlc_sim_channel_t *channel)
+{
+	const double ber = channel->config.bit_error_rate;
+
+	if (ber <= 0.0) {
+		return UINT64_MAX;
+	}
+
+	if (ber >= 1.0) {
+		return 0;
+	}
+
+	const double gap = floor(log(_hdlc_sim_uniform(channel)) / log1p(-ber));
+
+	return gap >= 1.8e19 ? UINT64_MAX : (uint64_t)gap;
+}
+
+//--------------------------------------------------
+static uint8_t _hdlc_sim_corrupt(hdlc_sim_channel_t *channel, uint8_t byte)
+{
+	while (channel->bits_to_error < 8) {
+		byte ^= 1 << channel->bits_to_error;
+		channel->stats.bit_errors++;
+
+		const uint64_t gap = _hdlc_sim_error_gap(channel);
+		channel->bits_to_error = gap == UINT64_MAX ? gap : channel->bits_to_error + 1 + gap;
+	}
+
+	if (channel->bits_to_error != UINT64_MAX) {
+		channel->bits_to_error -= 8;
+	}
+
+	return byte;
+}
+
+//--------------------------------------------------
+static int _hdlc_sim_push(hdlc_sim_channel_t *channel, hdlc_sim_time_t now, uint8_t byte)
+{
+	if (channel->tail - channel->head == HDLC_SIM_CHANNEL_CAPACITY) {
+		channel->stats.overflows++;
+		return -1;
+	}
+
+	// Serialize behind whatever is still on the wire, then add the propagation delay
+	hdlc_sim_time_t start = channel->link_free_at > now ? channel->link_free_at : now;
+
+	channel->link_free_at = start + channel->byte_time;
+
+	channel->data[channel->tail & HDLC_SIM_CHANNEL_MASK] = byte;
+	channel->deliver_at[channel->tail & HDLC_SIM_CHANNEL_MASK] =
+		channel->link_free_at + channel->config.latency;
+	channel->tail++;
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_sim_channel_init(hdlc_sim_channel_t *channel, const hdlc_sim_config_t *config)
+{
+	if (channel == NULL || config == NULL) {
+		return -1;
+	}
+
+	memset(channel, 0, sizeof(*channel));
+
+	channel->config = *config;
+	channel->rng = config->seed;
+	channel->byte_time = config->bandwidth ? (8 * NSEC_PER_SEC) / config->bandwidth : 0;
+	channel->bits_to_error = _hdlc_sim_error_gap(channel);
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_sim_channel_write(hdlc_sim_channel_t *channel, hdlc_sim_time_t now, const uint8_t *data,
+			   int len)
+{
+	if (channel == NULL || data == NULL || len < 0) {
+		return -1;
+	}
+
+	for (int i = 0; i < len; i++) {
+		channel->stats.bytes_in++;
+
+		if (_hdlc_sim_chance(channel, channel->config.flag_insert_rate)) {
+			if (_hdlc_sim_push(channel, now, HDLC_SIM_FLAG) == 0) {
+				channel->stats.inserted_flags++;
+			}
+		}
+
+		if (_hdlc_sim_chance(channel, channel->config.drop_rate)) {
+			channel->stats.drops++;
+			continue;
+		}
+
+		_hdlc_sim_push(channel, now, _hdlc_sim_corrupt(channel, data[i]));
+	}
+
+	return len;
+}
+
+//--------------------------------------------------
+int hdlc_sim_channel_read(hdlc_sim_channel_t *channel, hdlc_sim_time_t now, uint8_t *data,
+			  int len)
+{
+	if (channel == NULL || data == NULL || len < 0) {
+		return -1;
+	}
+
+	int count = 0;
+
+	while (count < len && channel->head != channel->tail) {
+		const uint32_t index = channel->head & HDLC_SIM_CHANNEL_MASK;
+
+		if (channel->deliver_at[index] > now) {
+			break;
+		}
+
+		data[count++] = channel->data[index];
+		channel->head++;
+	}
+
+	channel->stats.bytes_out += count;
+
+	return count;
+}
+
+//--------------------------------------------------
+int hdlc_sim_channel_next_delivery(const hdlc_sim_channel_t *channel, hdlc_sim_time_t *time)
+{
+	if (channel == NULL || time == NULL) {
+		return -1;
+	}
+
+	if (channel->head == channel->tail) {
+		return -1;
+	}
+
+	*time = channel->deliver_at[channel->head & HDLC_SIM_CHANNEL_MASK];
+
+	return 0;
+}
+
+//--------------------------------------------------
+int hdlc_sim_channel_pending(const hdlc_sim_channel_t *channel)
+{
+	if (channel == NULL) {
+		return -1;
+	}
+
+	return (int)(channel->tail - channel->head);
+}
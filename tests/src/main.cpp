@@ -6,11 +6,47 @@
 
 extern "C" {
 #include <hdlc.h>
+#ifdef HDLC_TEST_BRIDGE
+#include <hdlc_bridge.h>
+#endif
+#include <hdlc_deframer.h>
+#include <hdlc_dispatch.h>
+#include <hdlc_fcs.h>
+#ifdef HDLC_TEST_IPC
+#include <hdlc_ipc.h>
+#endif
+#include <hdlc_log.h>
+#include <hdlc_retx.h>
+#include <hdlc_rtt.h>
+#include <hdlc_sim.h>
+#include <hdlc_timer.h>
+#include <hdlc_tx.h>
+#include <hdlc_tx_pipeline.h>
+#include <hdlc_tx_sched.h>
 }
 
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef HDLC_TEST_BRIDGE
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(HDLC_TEST_BRIDGE) || defined(HDLC_TEST_IPC)
+#include <unistd.h>
+#endif
+
+#ifdef HDLC_TEST_IPC
+#include <sys/wait.h>
+#endif
 
 //--------------------------------------------------
 bool operator==(const hdlc_frame_t &lhs, const hdlc_frame_t &rhs)
@@ -998,6 +1034,1858 @@ TEST(verify_decode_buffer_len_check_escaped, success)
 	}
 }
 
+//--------------------------------------------------
+TEST(verify_tx_sched_strict_before_weighted, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_STRICT, 0},
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 2), 0);
+
+	auto control = createIFrameControl(0x00, 0x00, 0x00);
+	hdlc_frame_t bulk = createFrame(control, 0x03, std::array<uint8_t, 4>{0x01, 0x02, 0x03, 0x04});
+	hdlc_frame_t urgent = createFrame(control, 0x05);
+
+	hdlc_tx_item_t items[3];
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[0], &bulk, 1), 0);
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[1], &bulk, 1), 0);
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[2], &urgent, 0), 0);
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[2], &urgent, 2), -1);
+	EXPECT_EQ(hdlc_tx_sched_pending(&sched), 3);
+
+	EXPECT_EQ(hdlc_tx_sched_dequeue(&sched), &items[2]);
+	EXPECT_EQ(hdlc_tx_sched_dequeue(&sched), &items[0]);
+	EXPECT_EQ(hdlc_tx_sched_dequeue(&sched), &items[1]);
+	EXPECT_EQ(hdlc_tx_sched_dequeue(&sched), nullptr);
+	EXPECT_EQ(hdlc_tx_sched_pending(&sched), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_tx_sched_weighted_share, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_WEIGHTED, 3},
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 2), 0);
+
+	// Full size frames so every quantum pays for exactly one frame per unit of weight
+	hdlc_frame_t frame = createEmptyFrame();
+	frame.info_len = HDLC_INFO_MAX_LEN;
+
+	hdlc_tx_item_t items[16];
+
+	for (int i = 0; i < 8; i++) {
+		EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[i], &frame, 0), 0);
+		EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[8 + i], &frame, 1), 0);
+	}
+
+	int sent[2] = {0, 0};
+
+	for (int i = 0; i < 8; i++) {
+		hdlc_tx_item_t *item = hdlc_tx_sched_dequeue(&sched);
+		ASSERT_NE(item, nullptr);
+		sent[item->class_id]++;
+	}
+
+	EXPECT_EQ(sent[0], 6);
+	EXPECT_EQ(sent[1], 2);
+}
+
+//--------------------------------------------------
+TEST(verify_tx_sched_encode, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 1), 0);
+
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+	hdlc_frame_t frame = createFrame(control, 0x03, std::array<uint8_t, 4>{0x04, 0x05, 0x06, 0x07});
+
+	hdlc_tx_item_t item;
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &item, &frame, 0), 0);
+
+	uint8_t buffer[64] = {0};
+
+	// A short buffer keeps the frame queued
+	EXPECT_EQ(hdlc_tx_sched_encode(&sched, buffer, 4), -1);
+	EXPECT_EQ(hdlc_tx_sched_pending(&sched), 1);
+
+	EXPECT_EQ(hdlc_tx_sched_encode(&sched, buffer, sizeof(buffer)), 10);
+	EXPECT_EQ(hdlc_tx_sched_encode(&sched, buffer, sizeof(buffer)), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_tx_preempt_weighted_frame, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_STRICT, 0},
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	hdlc_tx_t tx;
+
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 2), 0);
+	EXPECT_EQ(hdlc_tx_init(&tx, &sched, nullptr, nullptr), 0);
+
+	auto control = createIFrameControl(0x00, 0x00, 0x00);
+	hdlc_frame_t bulk = createEmptyFrame();
+	bulk.address = 0x03;
+	bulk.control = control;
+	bulk.info_len = 64;
+	for (int i = 0; i < bulk.info_len; i++) {
+		bulk.info[i] = static_cast<uint8_t>(i);
+	}
+
+	hdlc_frame_t urgent = createFrame(control, 0x05, std::array<uint8_t, 1>{0x7E});
+
+	uint8_t bulk_encoded[HDLC_ENCODED_MAX_LEN];
+	uint8_t urgent_encoded[HDLC_ENCODED_MAX_LEN];
+
+	const int bulk_len = hdlc_encode(&bulk, bulk_encoded, sizeof(bulk_encoded));
+	const int urgent_len = hdlc_encode(&urgent, urgent_encoded, sizeof(urgent_encoded));
+
+	hdlc_tx_item_t bulk_item;
+	hdlc_tx_item_t urgent_item;
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &bulk_item, &bulk, 1), 0);
+
+	uint8_t wire[512];
+	int wire_len = 0;
+
+	wire_len += hdlc_tx_pull(&tx, wire, 16);
+	EXPECT_EQ(wire_len, 16);
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &urgent_item, &urgent, 0), 0);
+
+	for (int result = 1; result > 0; wire_len += result) {
+		result = hdlc_tx_pull(&tx, wire + wire_len, 7);
+		ASSERT_GE(result, 0);
+	}
+
+	EXPECT_EQ(tx.aborts, 1U);
+	EXPECT_EQ(hdlc_tx_busy(&tx), 0);
+	ASSERT_EQ(wire_len, 16 + HDLC_ABORT_LEN + urgent_len + bulk_len);
+
+	// Partial bulk frame, abort sequence, urgent frame and the bulk frame again
+	EXPECT_EQ(memcmp(wire, bulk_encoded, 16), 0);
+	EXPECT_EQ(wire[16], 0x7D);
+	EXPECT_EQ(wire[17], 0x7E);
+	EXPECT_EQ(memcmp(wire + 18, urgent_encoded, urgent_len), 0);
+	EXPECT_EQ(memcmp(wire + 18 + urgent_len, bulk_encoded, bulk_len), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_tx_preempt_byte_at_a_time, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_STRICT, 0},
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	hdlc_tx_t tx;
+
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 2), 0);
+	EXPECT_EQ(hdlc_tx_init(&tx, &sched, nullptr, nullptr), 0);
+
+	auto control = createIFrameControl(0x00, 0x00, 0x00);
+	hdlc_frame_t bulk = createFrame(control, 0x03, std::array<uint8_t, 64>{});
+	hdlc_frame_t urgent = createFrame(control, 0x05, std::array<uint8_t, 2>{0x01, 0x02});
+
+	uint8_t bulk_encoded[HDLC_ENCODED_MAX_LEN];
+	uint8_t urgent_encoded[HDLC_ENCODED_MAX_LEN];
+
+	const int bulk_len = hdlc_encode(&bulk, bulk_encoded, sizeof(bulk_encoded));
+	const int urgent_len = hdlc_encode(&urgent, urgent_encoded, sizeof(urgent_encoded));
+
+	hdlc_tx_item_t bulk_item;
+	hdlc_tx_item_t urgent_item;
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &bulk_item, &bulk, 1), 0);
+
+	// A UART pump that only ever has room for one byte
+	uint8_t wire[512];
+	int wire_len = 0;
+
+	for (; wire_len < 16; wire_len++) {
+		ASSERT_EQ(hdlc_tx_pull(&tx, wire + wire_len, 1), 1);
+	}
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &urgent_item, &urgent, 0), 0);
+
+	while (hdlc_tx_busy(&tx) && wire_len < static_cast<int>(sizeof(wire))) {
+		ASSERT_EQ(hdlc_tx_pull(&tx, wire + wire_len, 1), 1);
+		wire_len++;
+	}
+
+	EXPECT_EQ(hdlc_tx_pull(&tx, wire, 1), 0);
+	EXPECT_EQ(tx.aborts, 1U);
+	ASSERT_EQ(wire_len, 16 + HDLC_ABORT_LEN + urgent_len + bulk_len);
+
+	EXPECT_EQ(memcmp(wire, bulk_encoded, 16), 0);
+	EXPECT_EQ(wire[16], 0x7D);
+	EXPECT_EQ(wire[17], 0x7E);
+	EXPECT_EQ(memcmp(wire + 18, urgent_encoded, urgent_len), 0);
+	EXPECT_EQ(memcmp(wire + 18 + urgent_len, bulk_encoded, bulk_len), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_tx_no_preempt_of_strict_frame, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_STRICT, 0},
+		{HDLC_TX_CLASS_STRICT, 0},
+	};
+
+	hdlc_tx_sched_t sched;
+	hdlc_tx_t tx;
+
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 2), 0);
+	EXPECT_EQ(hdlc_tx_init(&tx, &sched, nullptr, nullptr), 0);
+
+	auto control = createIFrameControl(0x00, 0x00, 0x00);
+	hdlc_frame_t first = createFrame(control, 0x03, std::array<uint8_t, 16>{});
+	hdlc_frame_t second = createFrame(control, 0x05);
+
+	hdlc_tx_item_t items[2];
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[0], &first, 1), 0);
+
+	uint8_t wire[128];
+	EXPECT_EQ(hdlc_tx_pull(&tx, wire, 4), 4);
+
+	EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &items[1], &second, 0), 0);
+
+	// 22 bytes for the first frame and 6 bytes for the second one
+	EXPECT_EQ(hdlc_tx_pull(&tx, wire + 4, sizeof(wire) - 4), 24);
+	EXPECT_EQ(tx.aborts, 0U);
+}
+
+//--------------------------------------------------
+TEST(verify_encoder_chunks_match_encode, success)
+{
+	auto control = createIFrameControl(0x7E, 0x7E, 0x7E);
+
+	hdlc_frame_t frame = createEmptyFrame();
+	frame.address = 0x7D;
+	frame.control = control;
+	frame.info_len = HDLC_INFO_MAX_LEN;
+	for (int i = 0; i < frame.info_len; i++) {
+		frame.info[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	uint8_t expected[HDLC_ENCODED_MAX_LEN];
+	const int expected_len = hdlc_encode(&frame, expected, sizeof(expected));
+	ASSERT_GT(expected_len, 0);
+
+	for (int chunk = 1; chunk <= 17; chunk++) {
+		hdlc_encoder_t encoder;
+		EXPECT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+
+		uint8_t output[HDLC_ENCODED_MAX_LEN];
+		int output_len = 0;
+
+		while (!hdlc_encoder_done(&encoder)) {
+			const int result = hdlc_encoder_pull(&encoder, output + output_len, chunk);
+			ASSERT_GT(result, 0);
+			ASSERT_LE(output_len + result, static_cast<int>(sizeof(output)));
+			output_len += result;
+		}
+
+		EXPECT_EQ(hdlc_encoder_pull(&encoder, output, chunk), 0);
+		ASSERT_EQ(output_len, expected_len);
+		EXPECT_EQ(memcmp(output, expected, expected_len), 0);
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_encoder_abort, success)
+{
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+	hdlc_frame_t frame = createFrame(control, 0x03, std::array<uint8_t, 2>{0x7E, 0x04});
+
+	uint8_t buffer[16] = {0};
+	hdlc_encoder_t encoder;
+
+	// Nothing on the wire yet, nothing to abort
+	EXPECT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+	EXPECT_EQ(hdlc_encoder_abort(&encoder, buffer, sizeof(buffer)), 0);
+	EXPECT_EQ(hdlc_encoder_done(&encoder), 1);
+
+	// Stop in the middle of the escaped information byte, the flag completes the abort
+	EXPECT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+	EXPECT_EQ(hdlc_encoder_pull(&encoder, buffer, 4), 4);
+	EXPECT_EQ(buffer[3], 0x7D);
+	EXPECT_EQ(hdlc_encoder_abort(&encoder, buffer, 0), -1);
+	EXPECT_EQ(hdlc_encoder_abort(&encoder, buffer, 1), 1);
+	EXPECT_EQ(buffer[0], 0x7E);
+	EXPECT_EQ(hdlc_encoder_done(&encoder), 1);
+
+	// Regular abort
+	EXPECT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+	EXPECT_EQ(hdlc_encoder_pull(&encoder, buffer, 3), 3);
+	EXPECT_EQ(hdlc_encoder_abort(&encoder, buffer, sizeof(buffer)), 2);
+	EXPECT_EQ(buffer[0], 0x7D);
+	EXPECT_EQ(buffer[1], 0x7E);
+
+	// Room for one byte only, the flag follows with the next pull
+	EXPECT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+	EXPECT_EQ(hdlc_encoder_pull(&encoder, buffer, 3), 3);
+	EXPECT_EQ(hdlc_encoder_abort(&encoder, buffer, 1), 1);
+	EXPECT_EQ(buffer[0], 0x7D);
+	EXPECT_EQ(hdlc_encoder_done(&encoder), 0);
+	EXPECT_EQ(hdlc_encoder_pull(&encoder, buffer, sizeof(buffer)), 1);
+	EXPECT_EQ(buffer[0], 0x7E);
+	EXPECT_EQ(hdlc_encoder_done(&encoder), 1);
+}
+
+namespace
+{
+struct PipelineContext {
+	hdlc_tx_t *tx;
+	std::vector<const uint8_t *> started;
+	std::vector<uint8_t> wire;
+};
+
+//--------------------------------------------------
+int pipelineSource(void *user, uint8_t *data, int len)
+{
+	auto *context = static_cast<PipelineContext *>(user);
+	return hdlc_tx_pull(context->tx, data, len);
+}
+
+//--------------------------------------------------
+int pipelineStart(void *user, const uint8_t *data, int len)
+{
+	auto *context = static_cast<PipelineContext *>(user);
+	context->started.push_back(data);
+	context->wire.insert(context->wire.end(), data, data + len);
+	return 0;
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_tx_pipeline_double_buffering, success)
+{
+	const hdlc_tx_class_config_t config[] = {
+		{HDLC_TX_CLASS_WEIGHTED, 1},
+	};
+
+	hdlc_tx_sched_t sched;
+	hdlc_tx_t tx;
+
+	EXPECT_EQ(hdlc_tx_sched_init(&sched, config, 1), 0);
+	EXPECT_EQ(hdlc_tx_init(&tx, &sched, nullptr, nullptr), 0);
+
+	hdlc_frame_t frame = createEmptyFrame();
+	frame.address = 0x03;
+	frame.info_len = 100;
+	for (int i = 0; i < frame.info_len; i++) {
+		frame.info[i] = static_cast<uint8_t>(0x70 + (i % 16));
+	}
+
+	uint8_t expected[HDLC_ENCODED_MAX_LEN];
+	const int expected_len = hdlc_encode(&frame, expected, sizeof(expected));
+
+	hdlc_tx_item_t items[3];
+	for (auto &item : items) {
+		EXPECT_EQ(hdlc_tx_sched_enqueue(&sched, &item, &frame, 0), 0);
+	}
+
+	HDLC_TX_PIPELINE_STORAGE(storage, 64, 2);
+
+	PipelineContext context = {&tx, {}, {}};
+	hdlc_tx_pipeline_t pipeline;
+
+	EXPECT_EQ(hdlc_tx_pipeline_init(&pipeline, storage + 1, 64, 2, pipelineSource,
+					pipelineStart, &context),
+		  -1);
+	EXPECT_EQ(hdlc_tx_pipeline_init(&pipeline, storage, 64, 2, pipelineSource, pipelineStart,
+					&context),
+		  0);
+
+	// Both buffers get encoded, the first one goes out right away
+	EXPECT_EQ(hdlc_tx_pipeline_service(&pipeline), 0);
+	ASSERT_EQ(context.started.size(), 1U);
+	EXPECT_EQ(pipeline.ready, 2);
+
+	// Completion swaps to the other buffer before the encoder runs again
+	for (int i = 0; i < 32 && !hdlc_tx_pipeline_idle(&pipeline); i++) {
+		const size_t started = context.started.size();
+
+		EXPECT_EQ(hdlc_tx_pipeline_complete(&pipeline), 0);
+
+		if (pipeline.ready > 0) {
+			EXPECT_EQ(context.started.size(), started + 1);
+		}
+
+		EXPECT_EQ(hdlc_tx_pipeline_service(&pipeline), 0);
+	}
+
+	EXPECT_EQ(hdlc_tx_pipeline_idle(&pipeline), 1);
+	EXPECT_EQ(hdlc_tx_pipeline_complete(&pipeline), -1);
+
+	for (const uint8_t *data : context.started) {
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % HDLC_TX_PIPELINE_ALIGN, 0U);
+	}
+
+	ASSERT_EQ(context.wire.size(), 3U * expected_len);
+	for (int i = 0; i < 3; i++) {
+		EXPECT_EQ(memcmp(context.wire.data() + i * expected_len, expected, expected_len), 0);
+	}
+}
+
+namespace
+{
+struct ConcurrentPipeline {
+	hdlc_tx_pipeline_t pipeline;
+	int produced;
+	int total;
+	std::atomic<const uint8_t *> data;
+	std::atomic<int> len;
+	std::vector<uint8_t> wire;
+};
+
+//--------------------------------------------------
+int countingSource(void *user, uint8_t *data, int len)
+{
+	auto *context = static_cast<ConcurrentPipeline *>(user);
+
+	int written = 0;
+	for (; written < len && context->produced < context->total; written++) {
+		data[written] = static_cast<uint8_t>(context->produced++);
+	}
+
+	return written;
+}
+
+//--------------------------------------------------
+int handOverStart(void *user, const uint8_t *data, int len)
+{
+	auto *context = static_cast<ConcurrentPipeline *>(user);
+
+	// Only one transfer may be on the wire at any time
+	EXPECT_EQ(context->data.load(), nullptr);
+
+	context->len.store(len);
+	context->data.store(data);
+	return 0;
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_tx_pipeline_concurrent_complete, success)
+{
+	HDLC_TX_PIPELINE_STORAGE(storage, 64, 3);
+
+	ConcurrentPipeline context;
+	context.produced = 0;
+	context.total = 200000;
+	context.data.store(nullptr);
+	context.len.store(0);
+
+	EXPECT_EQ(hdlc_tx_pipeline_init(&context.pipeline, storage, 64, 3, countingSource,
+					handOverStart, &context),
+		  0);
+
+	// Completions come from another thread, as they would from a DMA interrupt
+	std::atomic<bool> stop(false);
+	std::thread dma([&context, &stop]() {
+		while (!stop.load()) {
+			const uint8_t *data = context.data.load();
+			if (data == nullptr) {
+				continue;
+			}
+
+			context.wire.insert(context.wire.end(), data, data + context.len.load());
+			context.data.store(nullptr);
+			EXPECT_EQ(hdlc_tx_pipeline_complete(&context.pipeline), 0);
+		}
+	});
+
+	while (context.produced < context.total || context.data.load() != nullptr ||
+	       !hdlc_tx_pipeline_idle(&context.pipeline)) {
+		EXPECT_EQ(hdlc_tx_pipeline_service(&context.pipeline), 0);
+	}
+
+	stop.store(true);
+	dma.join();
+
+	ASSERT_EQ(context.wire.size(), static_cast<size_t>(context.total));
+	for (int i = 0; i < context.total; i++) {
+		ASSERT_EQ(context.wire[i], static_cast<uint8_t>(i)) << "offset " << i;
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_retx_store_patches_control, success)
+{
+	auto control = createIFrameControl(0x03, 0x00, 0x01);
+	hdlc_frame_t frame =
+		createFrame(control, 0x7D, std::array<uint8_t, 6>{0x7E, 0x01, 0x7D, 0x02, 0x03, 0x7E});
+
+	hdlc_retx_store_t store;
+	EXPECT_EQ(hdlc_retx_store_init(&store), 0);
+	EXPECT_EQ(hdlc_retx_store_contains(&store, 0x03), 0);
+
+	uint8_t expected[HDLC_ENCODED_MAX_LEN];
+	const int stored_len = hdlc_encode(&frame, expected, sizeof(expected));
+
+	EXPECT_EQ(hdlc_retx_store_put(&store, &frame), stored_len);
+	EXPECT_EQ(hdlc_retx_store_contains(&store, 0x03), 1);
+
+	uint8_t output[HDLC_ENCODED_MAX_LEN];
+
+	// Unchanged control field is a plain copy
+	EXPECT_EQ(hdlc_retx_store_get(&store, 0x03, nullptr, output, sizeof(output)), stored_len);
+	EXPECT_EQ(memcmp(output, expected, stored_len), 0);
+
+	// Every control value, including the ones that need escaping, must match a full encode
+	for (int value = 0; value < 0x100; value++) {
+		frame.control.value = static_cast<uint8_t>(value);
+
+		const int expected_len = hdlc_encode(&frame, expected, sizeof(expected));
+		const int result =
+			hdlc_retx_store_get(&store, 0x03, &frame.control, output, sizeof(output));
+
+		ASSERT_EQ(result, expected_len) << "control " << value;
+		EXPECT_EQ(memcmp(output, expected, expected_len), 0) << "control " << value;
+	}
+
+	EXPECT_EQ(hdlc_retx_store_get(&store, 0x03, nullptr, output, 4), -1);
+	EXPECT_EQ(hdlc_retx_store_release(&store, 0x03), 0);
+	EXPECT_EQ(hdlc_retx_store_get(&store, 0x03, nullptr, output, sizeof(output)), -1);
+}
+
+//--------------------------------------------------
+TEST(verify_retx_store_round_trip, success)
+{
+	hdlc_retx_store_t store;
+	EXPECT_EQ(hdlc_retx_store_init(&store), 0);
+
+	hdlc_frame_t frame = createEmptyFrame();
+	frame.address = 0x03;
+	frame.info_len = HDLC_INFO_MAX_LEN;
+	for (int i = 0; i < frame.info_len; i++) {
+		frame.info[i] = static_cast<uint8_t>(i);
+	}
+
+	hdlc_i_frame_control_init(&frame.control, 0x05, 0x00, 0x00);
+	EXPECT_GT(hdlc_retx_store_put(&store, &frame), 0);
+
+	// Acknowledge progress through N(R) and the poll bit before retransmitting
+	hdlc_control_t control = {0};
+	hdlc_i_frame_control_init(&control, 0x05, 0x01, 0x06);
+
+	uint8_t output[HDLC_ENCODED_MAX_LEN];
+	const int result = hdlc_retx_store_get(&store, 0x05, &control, output, sizeof(output));
+	ASSERT_GT(result, 0);
+
+	hdlc_frame_t decoded_frame = createEmptyFrame();
+	EXPECT_EQ(hdlc_decode(&decoded_frame, output, result), 0);
+
+	frame.control = control;
+	EXPECT_EQ(frame, decoded_frame);
+}
+
+//--------------------------------------------------
+TEST(verify_encoded_set_control, success)
+{
+	const uint8_t controls[] = {0x00, 0x51, 0x7D, 0x7E, 0xFF, 0x7E, 0x10};
+
+	hdlc_frame_t frames[] = {
+		createFrame(createIFrameControl(0x00, 0x01, 0x02), 0x03),
+		createFrame(createIFrameControl(0x00, 0x01, 0x02), 0x7E,
+			    std::array<uint8_t, 4>{0x7E, 0x7D, 0x7E, 0x7D}),
+		createFrame(createIFrameControl(0x07, 0x00, 0x07), 0x7D,
+			    std::array<uint8_t, 5>{0x00, 0x11, 0x22, 0x33, 0x44}),
+	};
+
+	for (auto &frame : frames) {
+		uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+		int buffer_len = hdlc_encode(&frame, buffer, sizeof(buffer));
+		ASSERT_GT(buffer_len, 0);
+
+		// Chain the patches so escaped and plain control bytes follow each other
+		for (const uint8_t control : controls) {
+			frame.control.value = control;
+
+			uint8_t expected[HDLC_ENCODED_MAX_LEN];
+			const int expected_len = hdlc_encode(&frame, expected, sizeof(expected));
+
+			buffer_len = hdlc_encoded_set_control(buffer, buffer_len, sizeof(buffer), control);
+			ASSERT_EQ(buffer_len, expected_len);
+			EXPECT_EQ(memcmp(buffer, expected, expected_len), 0);
+		}
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_encoded_set_control_buffer_len_check, success)
+{
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+	hdlc_frame_t frame = createFrame(control, 0x03, std::array<uint8_t, 1>{0x04});
+
+	uint8_t buffer[64] = {0};
+	const int buffer_len = hdlc_encode(&frame, buffer, sizeof(buffer));
+	EXPECT_EQ(buffer_len, 7);
+
+	// Not a frame
+	EXPECT_EQ(hdlc_encoded_set_control(buffer, 5, sizeof(buffer), 0x00), -1);
+	EXPECT_EQ(hdlc_encoded_set_control(buffer, buffer_len - 1, sizeof(buffer), 0x00), -1);
+
+	// No room for the escaped control byte
+	EXPECT_EQ(hdlc_encoded_set_control(buffer, buffer_len, buffer_len, 0x7E), -1);
+	EXPECT_EQ(hdlc_encoded_set_control(buffer, buffer_len, buffer_len + 1, 0x7E), 8);
+}
+
+namespace
+{
+struct TimerRecord {
+	hdlc_timer_wheel_t *wheel;
+	hdlc_tick_t fired_at;
+	int fired;
+};
+
+//--------------------------------------------------
+void recordTimer(void *user, hdlc_timer_t *timer)
+{
+	(void)timer;
+
+	auto *record = static_cast<TimerRecord *>(user);
+	record->fired_at = record->wheel->tick - 1;
+	record->fired++;
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_timer_wheel_expiry, success)
+{
+	// Start close to the wrap of the tick counter
+	const hdlc_tick_t start = 0xFFFFF000U;
+	const hdlc_tick_t timeouts[] = {0, 1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 70000, 300000};
+
+	hdlc_timer_wheel_t wheel;
+	EXPECT_EQ(hdlc_timer_wheel_init(&wheel, start), 0);
+
+	hdlc_timer_t timers[sizeof(timeouts) / sizeof(timeouts[0])];
+	TimerRecord records[sizeof(timeouts) / sizeof(timeouts[0])];
+
+	for (size_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+		records[i] = {&wheel, 0, 0};
+		EXPECT_EQ(hdlc_timer_init(&timers[i], recordTimer, &records[i]), 0);
+		EXPECT_EQ(hdlc_timer_start(&wheel, &timers[i], timeouts[i]), 0);
+		EXPECT_EQ(hdlc_timer_active(&timers[i]), 1);
+	}
+
+	// Advance in uneven steps
+	hdlc_tick_t now = start;
+	for (hdlc_tick_t step = 1; now - start < 310000; step = (step * 7) % 97 + 1) {
+		now += step;
+		EXPECT_GE(hdlc_timer_wheel_advance(&wheel, now), 0);
+	}
+
+	for (size_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+		EXPECT_EQ(records[i].fired, 1) << "timeout " << timeouts[i];
+		EXPECT_EQ(hdlc_timer_active(&timers[i]), 0);
+
+		// A zero timeout runs on the next tick
+		const hdlc_tick_t expected = start + (timeouts[i] == 0 ? 1 : timeouts[i]);
+		EXPECT_EQ(records[i].fired_at, expected) << "timeout " << timeouts[i];
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_timer_wheel_cancel_restart, success)
+{
+	hdlc_timer_wheel_t wheel;
+	EXPECT_EQ(hdlc_timer_wheel_init(&wheel, 0), 0);
+
+	TimerRecord t1_record = {&wheel, 0, 0};
+	TimerRecord t2_record = {&wheel, 0, 0};
+
+	hdlc_timer_t t1;
+	hdlc_timer_t t2;
+
+	EXPECT_EQ(hdlc_timer_init(&t1, recordTimer, &t1_record), 0);
+	EXPECT_EQ(hdlc_timer_init(&t2, recordTimer, &t2_record), 0);
+
+	EXPECT_EQ(hdlc_timer_start(&wheel, &t1, 100), 0);
+	EXPECT_EQ(hdlc_timer_start(&wheel, &t2, 100), 0);
+
+	EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, 50), 0);
+
+	// Restarting pushes the expiry out, cancelling removes it
+	EXPECT_EQ(hdlc_timer_start(&wheel, &t1, 100), 0);
+	EXPECT_EQ(hdlc_timer_cancel(&wheel, &t2), 1);
+	EXPECT_EQ(hdlc_timer_cancel(&wheel, &t2), 0);
+
+	EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, 149), 0);
+	EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, 150), 1);
+	EXPECT_EQ(t1_record.fired_at, 150U);
+	EXPECT_EQ(t2_record.fired, 0);
+	EXPECT_EQ(wheel.active, 0);
+}
+
+namespace
+{
+//--------------------------------------------------
+void restartTimer(void *user, hdlc_timer_t *timer)
+{
+	recordTimer(user, timer);
+
+	auto *record = static_cast<TimerRecord *>(user);
+	EXPECT_EQ(hdlc_timer_start(record->wheel, timer, HDLC_TIMER_WHEEL_SLOTS), 0);
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_timer_wheel_periodic, success)
+{
+	hdlc_timer_wheel_t wheel;
+	EXPECT_EQ(hdlc_timer_wheel_init(&wheel, 0), 0);
+
+	// Restarted from its own callback for a full turn, so it goes back into the slot being run
+	TimerRecord record = {&wheel, 0, 0};
+	hdlc_timer_t timer;
+	EXPECT_EQ(hdlc_timer_init(&timer, restartTimer, &record), 0);
+	EXPECT_EQ(hdlc_timer_start(&wheel, &timer, HDLC_TIMER_WHEEL_SLOTS), 0);
+
+	for (int i = 1; i <= 10; i++) {
+		const hdlc_tick_t due = i * HDLC_TIMER_WHEEL_SLOTS;
+
+		EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, due - 1), 0);
+		EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, due), 1);
+		EXPECT_EQ(record.fired_at, due);
+	}
+
+	// Several turns in one call fire once per turn
+	EXPECT_EQ(hdlc_timer_wheel_advance(&wheel, 15 * HDLC_TIMER_WHEEL_SLOTS), 5);
+	EXPECT_EQ(record.fired, 15);
+	EXPECT_EQ(hdlc_timer_active(&timer), 1);
+}
+
+//--------------------------------------------------
+TEST(verify_rtt_converges, success)
+{
+	hdlc_rtt_t rtt;
+	EXPECT_EQ(hdlc_rtt_init(&rtt, 1000, 10, 60000), 0);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 1000U);
+
+	// First sample: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 * RTTVAR
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 0, 0), 0);
+	EXPECT_EQ(hdlc_rtt_on_ack(&rtt, 1, 100), 1);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 300U);
+
+	hdlc_tick_t now = 100;
+	for (int i = 1; i < 100; i++) {
+		const uint8_t ns = i & 0x07;
+
+		EXPECT_EQ(hdlc_rtt_on_send(&rtt, ns, now), 0);
+		now += 100;
+		EXPECT_EQ(hdlc_rtt_on_ack(&rtt, (ns + 1) & 0x07, now), 1);
+	}
+
+	// A steady link ends up just above its RTT
+	EXPECT_GE(hdlc_rtt_rto(&rtt), 100U);
+	EXPECT_LE(hdlc_rtt_rto(&rtt), 110U);
+}
+
+//--------------------------------------------------
+TEST(verify_rtt_karn_and_backoff, success)
+{
+	hdlc_rtt_t rtt;
+	EXPECT_EQ(hdlc_rtt_init(&rtt, 200, 10, 1000), 0);
+
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 3, 0), 0);
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 4, 0), 0);
+
+	// T1 expires, both frames go out again and the RTO doubles up to the maximum
+	EXPECT_EQ(hdlc_rtt_on_timeout(&rtt), 0);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 400U);
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 3, 400), 0);
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 4, 400), 0);
+	EXPECT_EQ(hdlc_rtt_on_timeout(&rtt), 0);
+	EXPECT_EQ(hdlc_rtt_on_timeout(&rtt), 0);
+	EXPECT_EQ(hdlc_rtt_on_timeout(&rtt), 0);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 1000U);
+
+	// Acking retransmitted frames gives no sample, the backoff stays
+	EXPECT_EQ(hdlc_rtt_on_ack(&rtt, 5, 450), 2);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 1000U);
+
+	// A clean sample resets the backoff
+	EXPECT_EQ(hdlc_rtt_on_send(&rtt, 5, 500), 0);
+	EXPECT_EQ(hdlc_rtt_on_ack(&rtt, 6, 540), 1);
+	EXPECT_EQ(hdlc_rtt_rto(&rtt), 120U);
+}
+
+//--------------------------------------------------
+TEST(verify_sim_channel_clean_timing, success)
+{
+	// 8 kbit/s gives one byte per millisecond
+	hdlc_sim_config_t config = {};
+	config.seed = 1;
+	config.latency = 5000000;
+	config.bandwidth = 8000;
+
+	auto channel = std::make_unique<hdlc_sim_channel_t>();
+	EXPECT_EQ(hdlc_sim_channel_init(channel.get(), &config), 0);
+
+	const uint8_t data[4] = {0x7E, 0x01, 0x02, 0x7E};
+	EXPECT_EQ(hdlc_sim_channel_write(channel.get(), 0, data, sizeof(data)), 4);
+
+	hdlc_sim_time_t next = 0;
+	EXPECT_EQ(hdlc_sim_channel_next_delivery(channel.get(), &next), 0);
+	EXPECT_EQ(next, 6000000U);
+
+	uint8_t output[8] = {0};
+	EXPECT_EQ(hdlc_sim_channel_read(channel.get(), 5999999, output, sizeof(output)), 0);
+	EXPECT_EQ(hdlc_sim_channel_read(channel.get(), 7000000, output, sizeof(output)), 2);
+	EXPECT_EQ(hdlc_sim_channel_read(channel.get(), 9000000, output + 2, sizeof(output)), 2);
+	EXPECT_EQ(memcmp(output, data, sizeof(data)), 0);
+	EXPECT_EQ(hdlc_sim_channel_pending(channel.get()), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_sim_channel_deterministic_errors, success)
+{
+	hdlc_sim_config_t config = {};
+	config.seed = 42;
+	config.bit_error_rate = 1e-3;
+	config.drop_rate = 1e-3;
+	config.flag_insert_rate = 1e-3;
+
+	auto first = std::make_unique<hdlc_sim_channel_t>();
+	auto second = std::make_unique<hdlc_sim_channel_t>();
+
+	EXPECT_EQ(hdlc_sim_channel_init(first.get(), &config), 0);
+	EXPECT_EQ(hdlc_sim_channel_init(second.get(), &config), 0);
+
+	std::vector<uint8_t> data(32768, 0x55);
+	std::vector<uint8_t> output_first(40000);
+	std::vector<uint8_t> output_second(40000);
+
+	EXPECT_EQ(hdlc_sim_channel_write(first.get(), 0, data.data(), data.size()), 32768);
+	EXPECT_EQ(hdlc_sim_channel_write(second.get(), 0, data.data(), data.size()), 32768);
+
+	const int first_len =
+		hdlc_sim_channel_read(first.get(), 0, output_first.data(), output_first.size());
+	const int second_len =
+		hdlc_sim_channel_read(second.get(), 0, output_second.data(), output_second.size());
+
+	// Same seed, same damage
+	ASSERT_EQ(first_len, second_len);
+	EXPECT_EQ(memcmp(output_first.data(), output_second.data(), first_len), 0);
+
+	// Roughly 262 bit errors and 33 drops and insertions expected
+	EXPECT_GT(first->stats.bit_errors, 180U);
+	EXPECT_LT(first->stats.bit_errors, 350U);
+	EXPECT_GT(first->stats.drops, 10U);
+	EXPECT_LT(first->stats.drops, 70U);
+	EXPECT_GT(first->stats.inserted_flags, 10U);
+	EXPECT_LT(first->stats.inserted_flags, 70U);
+	EXPECT_EQ(first_len, static_cast<int>(data.size() - first->stats.drops +
+					      first->stats.inserted_flags));
+}
+
+//--------------------------------------------------
+TEST(verify_sim_channel_decode_under_errors, success)
+{
+	hdlc_sim_config_t config = {};
+	config.seed = 7;
+	config.bit_error_rate = 1e-4;
+
+	auto channel = std::make_unique<hdlc_sim_channel_t>();
+	EXPECT_EQ(hdlc_sim_channel_init(channel.get(), &config), 0);
+
+	auto control = createIFrameControl(0x00, 0x00, 0x00);
+	hdlc_frame_t frame = createFrame(control, 0x03, std::array<uint8_t, 32>{});
+
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+	const int buffer_len = hdlc_encode(&frame, buffer, sizeof(buffer));
+
+	int good = 0;
+
+	for (int i = 0; i < 200; i++) {
+		EXPECT_EQ(hdlc_sim_channel_write(channel.get(), 0, buffer, buffer_len), buffer_len);
+
+		uint8_t received[HDLC_ENCODED_MAX_LEN];
+		const int received_len =
+			hdlc_sim_channel_read(channel.get(), 0, received, sizeof(received));
+
+		hdlc_frame_t decoded_frame = createEmptyFrame();
+		if (hdlc_decode(&decoded_frame, received, received_len) == 0) {
+			EXPECT_EQ(frame, decoded_frame);
+			good++;
+		}
+	}
+
+	// Accepted frames are intact, and only frames hit by an error go missing
+	EXPECT_GT(channel->stats.bit_errors, 0U);
+	EXPECT_GT(200 - good, 0);
+	EXPECT_LE(200 - good, static_cast<int>(channel->stats.bit_errors));
+}
+
+//--------------------------------------------------
+TEST(verify_encode_decode_escaped_fcs, success)
+{
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+
+	int escaped_fcs_frames = 0;
+
+	// Walk the information byte until both an escaped FCS high and low byte have been seen
+	for (int value = 0; value < 0x100; value++) {
+		hdlc_frame_t original_frame =
+			createFrame(control, 0x03, std::array<uint8_t, 2>{static_cast<uint8_t>(value), 0x00});
+		hdlc_frame_t decoded_frame = createEmptyFrame();
+
+		uint8_t buffer[64] = {0};
+		const int buffer_len = hdlc_encode(&original_frame, buffer, sizeof(buffer));
+		ASSERT_GT(buffer_len, 0);
+
+		const int info_len = (value == 0x7E || value == 0x7D) ? 3 : 2;
+		if (buffer_len > 1 + 1 + 1 + info_len + 2 + 1) {
+			escaped_fcs_frames++;
+		}
+
+		EXPECT_EQ(hdlc_decode(&decoded_frame, buffer, buffer_len), 0) << "info " << value;
+		EXPECT_EQ(original_frame, decoded_frame);
+	}
+
+	EXPECT_GT(escaped_fcs_frames, 0);
+}
+
+//--------------------------------------------------
+TEST(verify_encode_stays_within_buffer, success)
+{
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+
+	std::array<uint8_t, 32> information;
+	information.fill(0x7E);
+
+	hdlc_frame_t original_frame = createFrame(control, 0x03, information);
+
+	// Every information byte is escaped, so the frame runs out of room well before the end
+	for (int len = 0; len < 70; len++) {
+		uint8_t buffer[96];
+		memset(buffer, 0xA5, sizeof(buffer));
+
+		EXPECT_EQ(hdlc_encode(&original_frame, buffer, len), -1);
+
+		for (size_t i = len; i < sizeof(buffer); i++) {
+			ASSERT_EQ(buffer[i], 0xA5) << "len " << len << " index " << i;
+		}
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_decode_info_len_limit, success)
+{
+	auto control = createIFrameControl(0x00, 0x01, 0x02);
+
+	std::array<uint8_t, 100> information;
+	information.fill(0x55);
+
+	hdlc_frame_t original_frame = createFrame(control, 0x03, information);
+
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN] = {0};
+	const int buffer_len = hdlc_encode(&original_frame, buffer, sizeof(buffer));
+	ASSERT_GT(buffer_len, 0);
+
+	// Appending to an information field that is already well filled must not run off its end
+	hdlc_frame_t decoded_frame = createEmptyFrame();
+	decoded_frame.info_len = HDLC_INFO_MAX_LEN - 10;
+
+	EXPECT_EQ(hdlc_decode(&decoded_frame, buffer, buffer_len), -1);
+	EXPECT_EQ(decoded_frame.info_len, HDLC_INFO_MAX_LEN);
+}
+
+//--------------------------------------------------
+TEST(verify_decode_truncated_escape, success)
+{
+	// A frame cut off right after an escape byte
+	uint8_t buffer[] = {0x7E, 0x7D};
+
+	hdlc_frame_t decoded_frame = createEmptyFrame();
+
+	EXPECT_EQ(hdlc_decode(&decoded_frame, buffer, sizeof(buffer)), -1);
+}
+
+namespace
+{
+struct DeframerRecord {
+	std::vector<hdlc_frame_t> frames;
+	std::vector<int> encoded_lens;
+};
+
+//--------------------------------------------------
+void recordFrame(void *user, const hdlc_frame_desc_t *desc)
+{
+	auto *record = static_cast<DeframerRecord *>(user);
+	record->frames.push_back(*desc->frame);
+	record->encoded_lens.push_back(desc->encoded_len);
+}
+
+//--------------------------------------------------
+void appendEncoded(std::vector<uint8_t> &stream, const hdlc_frame_t &frame)
+{
+	uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+
+	const int len = hdlc_encode(&frame, buffer, sizeof(buffer));
+	ASSERT_GT(len, 0);
+
+	stream.insert(stream.end(), buffer, buffer + len);
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_deframer_stream, success)
+{
+	const hdlc_frame_t frames[] = {
+		createFrame(createIFrameControl(0x00, 0x00, 0x00), 0x03,
+			    std::array<uint8_t, 4>{0x04, 0x05, 0x06, 0x07}),
+		createFrame(createIFrameControl(0x01, 0x01, 0x02), 0x7E,
+			    std::array<uint8_t, 3>{0x7D, 0x7E, 0x5E}),
+		createFrame(createIFrameControl(0x02, 0x00, 0x03), 0x7D),
+	};
+
+	// Line noise before the first flag and idle flags between frames
+	std::vector<uint8_t> stream = {0x12, 0x7D, 0x34};
+	for (const auto &frame : frames) {
+		appendEncoded(stream, frame);
+		stream.push_back(0x7E);
+	}
+
+	// Whole stream at once and one byte at a time must give the same frames
+	for (int chunk : {static_cast<int>(stream.size()), 1}) {
+		DeframerRecord record;
+		hdlc_frame_t frame = createEmptyFrame();
+
+		hdlc_deframer_t deframer;
+		ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, recordFrame, &record), 0);
+
+		int delivered = 0;
+		for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+			const int len = std::min<int>(chunk, stream.size() - offset);
+			delivered += hdlc_deframer_push(&deframer, stream.data() + offset, len);
+		}
+
+		EXPECT_EQ(delivered, 3);
+		ASSERT_EQ(record.frames.size(), 3u);
+
+		for (size_t i = 0; i < 3; i++) {
+			uint8_t buffer[HDLC_ENCODED_MAX_LEN];
+			const int len = hdlc_encode(&frames[i], buffer, sizeof(buffer));
+
+			EXPECT_EQ(record.frames[i], frames[i]);
+			EXPECT_EQ(record.encoded_lens[i], len - 1);
+		}
+
+		EXPECT_EQ(deframer.stats.frames, 3u);
+		EXPECT_EQ(deframer.stats.fcs_errors, 0u);
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_deframer_errors, success)
+{
+	const hdlc_frame_t good =
+		createFrame(createIFrameControl(0x00, 0x00, 0x00), 0x03, std::array<uint8_t, 1>{0x42});
+
+	std::vector<uint8_t> stream;
+
+	// Aborted frame
+	stream.insert(stream.end(), {0x7E, 0x03, 0x10, 0x7D, 0x7E});
+
+	// Escape followed by an escape, everything up to the next flag is dropped
+	stream.insert(stream.end(), {0x03, 0x10, 0x7D, 0x7D, 0x01, 0x02});
+
+	// Too short to hold an FCS
+	stream.insert(stream.end(), {0x7E, 0x03, 0x10, 0x7E});
+
+	// More bytes between two flags than any frame can hold
+	stream.insert(stream.end(), HDLC_INFO_MAX_LEN + 8, 0x55);
+	stream.push_back(0x7E);
+
+	// Damaged FCS
+	std::vector<uint8_t> damaged;
+	appendEncoded(damaged, good);
+	damaged[damaged.size() - 2] ^= 0x01;
+	stream.insert(stream.end(), damaged.begin(), damaged.end());
+
+	// A good frame is still picked up after all of that
+	appendEncoded(stream, good);
+
+	DeframerRecord record;
+	hdlc_frame_t frame = createEmptyFrame();
+
+	hdlc_deframer_t deframer;
+	ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, recordFrame, &record), 0);
+
+	EXPECT_EQ(hdlc_deframer_push(&deframer, stream.data(), stream.size()), 1);
+	ASSERT_EQ(record.frames.size(), 1u);
+	EXPECT_EQ(record.frames[0], good);
+
+	EXPECT_EQ(deframer.stats.aborts, 1u);
+	EXPECT_EQ(deframer.stats.escape_errors, 1u);
+	EXPECT_EQ(deframer.stats.length_errors, 2u);
+	EXPECT_EQ(deframer.stats.fcs_errors, 1u);
+	EXPECT_EQ(deframer.stats.frames, 1u);
+}
+
+//--------------------------------------------------
+TEST(verify_encode_decode_escape_positions, success)
+{
+	auto control = createIFrameControl(0x03, 0x00, 0x05);
+
+	// Move a flag and an escape byte through every position of a frame that spans several words
+	for (size_t position = 0; position < 40; position++) {
+		std::array<uint8_t, 40> information;
+		for (size_t i = 0; i < information.size(); i++) {
+			information[i] = static_cast<uint8_t>(0x30 + i);
+		}
+
+		information[position] = 0x7E;
+		information[(position * 7) % information.size()] = 0x7D;
+
+		hdlc_frame_t original_frame = createFrame(control, 0x03, information);
+
+		std::vector<uint8_t> stream;
+		appendEncoded(stream, original_frame);
+
+		hdlc_frame_t decoded_frame = createEmptyFrame();
+		ASSERT_EQ(hdlc_decode(&decoded_frame, stream.data(), stream.size()), 0);
+		EXPECT_EQ(original_frame, decoded_frame);
+
+		// The resumable encoder must produce the same bytes, whatever the chunk size
+		for (int chunk = 1; chunk <= 9; chunk += 4) {
+			hdlc_encoder_t encoder;
+			ASSERT_EQ(hdlc_encoder_init(&encoder, &original_frame), 0);
+
+			std::vector<uint8_t> pulled;
+			while (!hdlc_encoder_done(&encoder)) {
+				uint8_t buffer[16];
+				const int len = hdlc_encoder_pull(&encoder, buffer, chunk);
+				ASSERT_GE(len, 0);
+				pulled.insert(pulled.end(), buffer, buffer + len);
+			}
+
+			EXPECT_EQ(pulled, stream);
+		}
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_deframer_escape_dense_blocks, success)
+{
+	auto control = createIFrameControl(0x01, 0x00, 0x02);
+
+	// Dense escapes put escape pairs, and escapes split from their partner, on block boundaries
+	for (size_t stride = 2; stride <= 5; stride++) {
+		std::array<uint8_t, 200> information;
+		for (size_t i = 0; i < information.size(); i++) {
+			if (i % stride == 0) {
+				information[i] = (i / stride) % 2 ? 0x7E : 0x7D;
+			} else {
+				information[i] = static_cast<uint8_t>(i);
+			}
+		}
+
+		hdlc_frame_t original_frame = createFrame(control, 0x03, information);
+
+		std::vector<uint8_t> stream;
+		appendEncoded(stream, original_frame);
+		appendEncoded(stream, original_frame);
+
+		for (size_t chunk : {size_t(1), size_t(61), size_t(64), stream.size()}) {
+			hdlc_frame_t frame = createEmptyFrame();
+			hdlc_deframer_t deframer;
+			DeframerRecord record;
+			ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, recordFrame, &record), 0);
+
+			for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+				const size_t len = std::min(chunk, stream.size() - offset);
+				ASSERT_GE(hdlc_deframer_push(&deframer, stream.data() + offset, len), 0);
+			}
+
+			ASSERT_EQ(record.frames.size(), 2u);
+			EXPECT_EQ(record.frames[0], original_frame);
+			EXPECT_EQ(record.frames[1], original_frame);
+			EXPECT_EQ(deframer.stats.fcs_errors, 0u);
+		}
+	}
+}
+
+//--------------------------------------------------
+TEST(verify_encode_batch_matches_encode, success)
+{
+	// Batches that fill the lanes, leave some empty, and mix short frames with escaped ones
+	for (int count = 1; count <= 9; count++) {
+		std::vector<hdlc_frame_t> frames;
+		for (int i = 0; i < count; i++) {
+			auto control = createIFrameControl(i & 0x07, 0x00, 0x01);
+
+			std::vector<uint8_t> information(static_cast<size_t>(i * 7 % 50));
+			for (size_t j = 0; j < information.size(); j++) {
+				information[j] = static_cast<uint8_t>(0x7B + i + j);
+			}
+
+			hdlc_frame_t frame = createEmptyFrame();
+			frame.address = static_cast<uint8_t>(0x7C + i);
+			frame.control = control;
+			std::copy(information.begin(), information.end(), frame.info);
+			frame.info_len = static_cast<hdlc_info_len_t>(information.size());
+
+			frames.push_back(frame);
+		}
+
+		std::vector<std::array<uint8_t, HDLC_ENCODED_MAX_LEN>> buffers(count);
+		std::vector<uint8_t *> data(count);
+		std::vector<int> len(count, HDLC_ENCODED_MAX_LEN);
+		std::vector<int> encoded_lens(count, 0);
+
+		for (int i = 0; i < count; i++) {
+			data[i] = buffers[i].data();
+		}
+
+		ASSERT_EQ(hdlc_encode_batch(frames.data(), count, data.data(), len.data(),
+					    encoded_lens.data()),
+			  0);
+
+		for (int i = 0; i < count; i++) {
+			uint8_t expected[HDLC_ENCODED_MAX_LEN];
+			const int expected_len = hdlc_encode(&frames[i], expected, sizeof(expected));
+
+			ASSERT_EQ(encoded_lens[i], expected_len);
+			EXPECT_EQ(memcmp(data[i], expected, expected_len), 0);
+		}
+	}
+
+	// A buffer too small for its frame fails the batch
+	hdlc_frame_t frame = createEmptyFrame();
+	uint8_t buffer[3];
+	uint8_t *data = buffer;
+	const int len = sizeof(buffer);
+	int encoded_len = 0;
+
+	EXPECT_EQ(hdlc_encode_batch(&frame, 1, &data, &len, &encoded_len), -1);
+}
+
+//--------------------------------------------------
+TEST(verify_fcs_combine_chunks, success)
+{
+	std::vector<uint8_t> payload(100000);
+	for (size_t i = 0; i < payload.size(); i++) {
+		payload[i] = static_cast<uint8_t>(i * 131 + (i >> 9));
+	}
+
+	uint16_t expected = 0;
+	ASSERT_EQ(hdlc_fcs_calculate(payload.data(), payload.size(), &expected), 0);
+
+	// Checksum uneven chunks on their own, as separate threads would, then merge them in order
+	for (size_t chunks : {size_t(1), size_t(2), size_t(3), size_t(7), size_t(64)}) {
+		const size_t chunk_len = payload.size() / chunks + 1;
+
+		uint16_t combined = 0;
+		ASSERT_EQ(hdlc_fcs_calculate(payload.data(), 0, &combined), 0);
+
+		for (size_t offset = 0; offset < payload.size(); offset += chunk_len) {
+			const size_t len = std::min(chunk_len, payload.size() - offset);
+
+			uint16_t fcs = 0;
+			ASSERT_EQ(hdlc_fcs_calculate(payload.data() + offset, len, &fcs), 0);
+
+			combined = hdlc_fcs_combine(combined, fcs, len);
+		}
+
+		EXPECT_EQ(combined, expected);
+	}
+
+	// Lengths that reach past the period of the power table
+	for (size_t len : {size_t(0), size_t(1), size_t(32767), size_t(65536), size_t(99999)}) {
+		uint16_t head = 0;
+		uint16_t tail = 0;
+		ASSERT_EQ(hdlc_fcs_calculate(payload.data(), payload.size() - len, &head), 0);
+		ASSERT_EQ(hdlc_fcs_calculate(payload.data() + payload.size() - len, len, &tail), 0);
+
+		EXPECT_EQ(hdlc_fcs_combine(head, tail, len), expected);
+	}
+
+	uint16_t fcs = 0;
+	EXPECT_EQ(hdlc_fcs_calculate(nullptr, 1, &fcs), -1);
+	EXPECT_EQ(hdlc_fcs_calculate(payload.data(), -1, &fcs), -1);
+	EXPECT_EQ(hdlc_fcs_calculate(payload.data(), 1, nullptr), -1);
+}
+
+//--------------------------------------------------
+TEST(verify_dispatch_kernels_agree, success)
+{
+	const hdlc_kernels_id_t active = hdlc_dispatch_active();
+	EXPECT_TRUE(hdlc_dispatch_supported(active));
+	EXPECT_TRUE(hdlc_dispatch_supported(HDLC_KERNELS_SCALAR));
+	EXPECT_STREQ(hdlc_dispatch_name(HDLC_KERNELS_SCALAR), "scalar");
+	EXPECT_EQ(hdlc_dispatch_name(HDLC_KERNELS_COUNT), nullptr);
+	EXPECT_EQ(hdlc_dispatch_select(HDLC_KERNELS_COUNT), -1);
+
+	// Good frames of every size, damaged ones and line noise in between
+	std::vector<uint8_t> stream;
+	uint32_t seed = 12345;
+	for (int i = 0; i < 300; i++) {
+		hdlc_frame_t frame = createEmptyFrame();
+		frame.address = static_cast<uint8_t>(i);
+		frame.control.value = static_cast<uint8_t>(i * 3);
+		frame.info_len = static_cast<hdlc_info_len_t>(i % (HDLC_INFO_MAX_LEN + 1));
+
+		for (int j = 0; j < frame.info_len; j++) {
+			seed = seed * 1103515245 + 12345;
+			const uint8_t value = static_cast<uint8_t>(seed >> 16);
+			frame.info[j] = (value & 3) == 0 ? 0x7D + (value >> 7) : value;
+		}
+
+		const size_t start = stream.size();
+		appendEncoded(stream, frame);
+
+		if (i % 5 == 0) {
+			stream[start + (seed % (stream.size() - start))] ^= 0x20;
+		} else if (i % 7 == 0) {
+			stream.insert(stream.end(), {0x7D, 0x7D, 0x01, 0x7D});
+		}
+	}
+
+	std::vector<DeframerRecord> records(HDLC_KERNELS_COUNT);
+	std::vector<hdlc_deframer_stats_t> stats(HDLC_KERNELS_COUNT);
+
+	for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+		const auto kernels = static_cast<hdlc_kernels_id_t>(id);
+		if (!hdlc_dispatch_supported(kernels)) {
+			continue;
+		}
+
+		ASSERT_EQ(hdlc_dispatch_select(kernels), 0);
+		EXPECT_EQ(hdlc_dispatch_active(), kernels);
+
+		hdlc_frame_t frame = createEmptyFrame();
+		hdlc_deframer_t deframer;
+		ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, recordFrame, &records[id]), 0);
+
+		for (size_t offset = 0; offset < stream.size(); offset += 1000) {
+			const size_t len = std::min(size_t(1000), stream.size() - offset);
+			ASSERT_GE(hdlc_deframer_push(&deframer, stream.data() + offset, len), 0);
+		}
+
+		stats[id] = deframer.stats;
+
+		EXPECT_GT(records[id].frames.size(), 200u);
+		EXPECT_EQ(records[id].frames, records[HDLC_KERNELS_SCALAR].frames);
+		EXPECT_EQ(records[id].encoded_lens, records[HDLC_KERNELS_SCALAR].encoded_lens);
+		EXPECT_EQ(memcmp(&stats[id], &stats[HDLC_KERNELS_SCALAR], sizeof(stats[id])), 0);
+	}
+
+	// Blocks start right after the first data byte of a frame. End the first block of one frame
+	// with an escape pair, then the data of another right before its closing flag.
+	std::vector<uint8_t> edges;
+	for (int before : {63, 40}) {
+		std::vector<uint8_t> frame(before, 0x41);
+		frame.insert(frame.end(), {0x7D, 0x7D});
+
+		// The first frame is good apart from the pair
+		if (before == 63) {
+			frame.insert(frame.end(), 70, 0x42);
+
+			uint16_t fcs = 0;
+			ASSERT_EQ(hdlc_fcs_calculate(frame.data(), frame.size(), &fcs), 0);
+
+			const uint8_t fcs_bytes[] = {static_cast<uint8_t>(fcs >> 8),
+						     static_cast<uint8_t>(fcs & 0xFF)};
+			for (uint8_t byte : fcs_bytes) {
+				if (byte == 0x7E || byte == 0x7D) {
+					frame.push_back(0x7D);
+					frame.push_back(byte ^ 0x20);
+				} else {
+					frame.push_back(byte);
+				}
+			}
+		}
+
+		edges.push_back(0x7E);
+		edges.insert(edges.end(), frame.begin(), frame.end());
+		edges.push_back(0x7E);
+	}
+
+	for (int id = 0; id < HDLC_KERNELS_COUNT; id++) {
+		const auto kernels = static_cast<hdlc_kernels_id_t>(id);
+		if (!hdlc_dispatch_supported(kernels)) {
+			continue;
+		}
+
+		ASSERT_EQ(hdlc_dispatch_select(kernels), 0);
+
+		hdlc_frame_t frame = createEmptyFrame();
+		hdlc_deframer_t deframer;
+		ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, nullptr, nullptr), 0);
+		EXPECT_EQ(hdlc_deframer_push(&deframer, edges.data(), edges.size()), 0);
+
+		EXPECT_EQ(deframer.stats.escape_errors, 2u) << hdlc_dispatch_name(kernels);
+		EXPECT_EQ(deframer.stats.fcs_errors, 0u) << hdlc_dispatch_name(kernels);
+		EXPECT_EQ(deframer.stats.aborts, 0u) << hdlc_dispatch_name(kernels);
+	}
+
+	ASSERT_EQ(hdlc_dispatch_select(active), 0);
+
+	// Switching kernels while another thread deframes changes nothing in what it finds
+	DeframerRecord concurrent;
+	std::thread worker([&stream, &concurrent]() {
+		hdlc_frame_t frame = createEmptyFrame();
+		hdlc_deframer_t deframer;
+		ASSERT_EQ(hdlc_deframer_init(&deframer, &frame, recordFrame, &concurrent), 0);
+
+		for (size_t offset = 0; offset < stream.size(); offset += 100) {
+			const size_t len = std::min(size_t(100), stream.size() - offset);
+			ASSERT_GE(hdlc_deframer_push(&deframer, stream.data() + offset, len), 0);
+		}
+	});
+
+	for (int i = 0; i < 1000; i++) {
+		ASSERT_EQ(hdlc_dispatch_select(i % 2 ? active : HDLC_KERNELS_SCALAR), 0);
+	}
+
+	worker.join();
+
+	EXPECT_EQ(concurrent.frames, records[HDLC_KERNELS_SCALAR].frames);
+
+	ASSERT_EQ(hdlc_dispatch_select(active), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_log_format, success)
+{
+	hdlc_log_event_t event = {};
+	event.fmt = "[%s:%d] %s %d%%\n";
+	event.values[0] = reinterpret_cast<uintptr_t>("hdlc_encode");
+	event.values[1] = 42;
+	event.values[2] = reinterpret_cast<uintptr_t>("len");
+	event.values[3] = static_cast<uint64_t>(-7);
+	event.count = 4;
+
+	char buf[64];
+	EXPECT_EQ(hdlc_log_format(&event, buf, sizeof(buf)), 25);
+	EXPECT_STREQ(buf, "[hdlc_encode:42] len -7%\n");
+
+	// Truncated like snprintf, always terminated
+	EXPECT_EQ(hdlc_log_format(&event, buf, 8), 7);
+	EXPECT_STREQ(buf, "[hdlc_e");
+
+	EXPECT_EQ(hdlc_log_format(nullptr, buf, sizeof(buf)), -1);
+	EXPECT_EQ(hdlc_log_format(&event, buf, 0), -1);
+}
+
+//--------------------------------------------------
+TEST(verify_log_ring_per_thread, success)
+{
+	std::vector<std::string> messages;
+	const auto collect = [](void *user, const hdlc_log_event_t *event) {
+		char buf[128];
+		ASSERT_GE(hdlc_log_format(event, buf, sizeof(buf)), 0);
+		static_cast<std::vector<std::string> *>(user)->push_back(buf);
+	};
+
+	// Errors recorded by earlier tests
+	if (hdlc_log_drain(collect, &messages) < 0) {
+		GTEST_SKIP() << "built without HDLC_LOG_ENABLED";
+	}
+
+	messages.clear();
+	const uint32_t dropped = hdlc_log_dropped();
+
+	uint8_t buf[HDLC_ENCODED_MAX_LEN];
+	EXPECT_EQ(hdlc_encode(nullptr, buf, sizeof(buf)), -1);
+
+	std::thread worker([&buf]() {
+		EXPECT_EQ(hdlc_decode(nullptr, buf, 0), -1);
+		hdlc_log_release();
+	});
+	worker.join();
+
+	EXPECT_EQ(hdlc_log_drain(collect, &messages), 2);
+	EXPECT_EQ(hdlc_log_dropped(), dropped);
+	EXPECT_EQ(hdlc_log_drain(collect, &messages), 0);
+
+	ASSERT_EQ(messages.size(), 2u);
+	EXPECT_EQ(messages[0].rfind("[hdlc_encode:", 0), 0u);
+	EXPECT_EQ(messages[1].rfind("[hdlc_decode:", 0), 0u);
+}
+
+namespace
+{
+//--------------------------------------------------
+uint64_t lineClock(void *user)
+{
+	return *static_cast<uint64_t *>(user);
+}
+
+//--------------------------------------------------
+void recordTimes(void *user, const hdlc_frame_desc_t *desc)
+{
+	static_cast<std::vector<hdlc_deframer_times_t> *>(user)->push_back(desc->times);
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_frame_timestamps, success)
+{
+	const std::array<uint8_t, 4> info = {0x01, 0x7E, 0x02, 0x03};
+	const hdlc_frame_t frame = createFrame(createIFrameControl(1, 0, 2), 0x05, info);
+
+	// Pulled one byte at a time, the clock reads the position on the line
+	uint64_t now = 0;
+	hdlc_encoder_t encoder;
+	ASSERT_EQ(hdlc_encoder_init(&encoder, &frame), 0);
+	ASSERT_EQ(hdlc_encoder_set_clock(&encoder, lineClock, &now), 0);
+
+	std::vector<uint8_t> stream;
+	while (!hdlc_encoder_done(&encoder)) {
+		uint8_t byte;
+		now = stream.size() + 1;
+		ASSERT_EQ(hdlc_encoder_pull(&encoder, &byte, 1), 1);
+		stream.push_back(byte);
+	}
+
+	EXPECT_EQ(encoder.times.first_byte, 1u);
+	EXPECT_GT(encoder.times.fcs, encoder.times.first_byte);
+	EXPECT_LE(encoder.times.fcs, stream.size() - 3);
+	EXPECT_EQ(encoder.times.flag, stream.size());
+
+	std::vector<hdlc_deframer_times_t> times;
+	hdlc_frame_t decoded = createEmptyFrame();
+	hdlc_deframer_t deframer;
+	ASSERT_EQ(hdlc_deframer_init(&deframer, &decoded, recordTimes, &times), 0);
+	ASSERT_EQ(hdlc_deframer_set_clock(&deframer, lineClock, &now), 0);
+
+	for (size_t i = 0; i < stream.size(); i++) {
+		now = i + 1;
+		ASSERT_GE(hdlc_deframer_push(&deframer, &stream[i], 1), 0);
+	}
+
+	// Without a clock every timestamp stays zero
+	ASSERT_EQ(hdlc_deframer_set_clock(&deframer, nullptr, nullptr), 0);
+	ASSERT_EQ(hdlc_deframer_push(&deframer, stream.data(), stream.size()), 1);
+
+	ASSERT_EQ(times.size(), 2u);
+	EXPECT_EQ(times[0].first_byte, 2u);
+	EXPECT_EQ(times[0].flag, stream.size());
+	EXPECT_EQ(times[0].fcs, stream.size());
+	EXPECT_EQ(times[0].delivered, stream.size());
+
+	const hdlc_deframer_times_t none = {};
+	EXPECT_EQ(memcmp(&times[1], &none, sizeof(none)), 0);
+}
+
+#ifdef HDLC_TEST_BRIDGE
+namespace
+{
+//--------------------------------------------------
+void bridgeFrames(int tx_fd, int rx_fd, hdlc_bridge_transport_t transport)
+{
+	std::vector<hdlc_frame_t> frames;
+	std::vector<uint8_t> stream;
+	for (int i = 0; i < 300; i++) {
+		hdlc_frame_t frame = createEmptyFrame();
+		frame.address = static_cast<uint8_t>(i);
+		frame.control.value = static_cast<uint8_t>(0x7E - i);
+		frame.info_len = static_cast<hdlc_info_len_t>((i * 37) % (HDLC_INFO_MAX_LEN + 1));
+
+		for (int j = 0; j < frame.info_len; j++) {
+			frame.info[j] = static_cast<uint8_t>(i + j * 0x3D);
+		}
+
+		frames.push_back(frame);
+		appendEncoded(stream, frame);
+	}
+
+	auto tx = std::make_unique<hdlc_bridge_t>();
+	auto rx = std::make_unique<hdlc_bridge_t>();
+	ASSERT_EQ(hdlc_bridge_init(tx.get(), tx_fd, transport), 0);
+	ASSERT_EQ(hdlc_bridge_init(rx.get(), rx_fd, transport), 0);
+
+	// Channel reads of uneven size, frames straddle them
+	int found = 0;
+	for (size_t offset = 0; offset < stream.size(); offset += 4093) {
+		const int len = std::min<int>(4093, stream.size() - offset);
+		const int result = hdlc_bridge_push(tx.get(), stream.data() + offset, len);
+		ASSERT_GE(result, 0);
+		found += result;
+	}
+
+	EXPECT_EQ(found, 300);
+	EXPECT_EQ(hdlc_bridge_pending(tx.get()), 0);
+	EXPECT_EQ(tx->stats.frames_out, 300u);
+	EXPECT_LT(tx->stats.send_calls, 300u / 4);
+
+	DeframerRecord record;
+	hdlc_frame_t decoded = createEmptyFrame();
+	hdlc_deframer_t deframer;
+	ASSERT_EQ(hdlc_deframer_init(&deframer, &decoded, recordFrame, &record), 0);
+
+	while (record.frames.size() < frames.size()) {
+		uint8_t buffer[1500];
+		const int len = hdlc_bridge_pull(rx.get(), buffer, sizeof(buffer));
+		ASSERT_GE(len, 0);
+
+		if (len == 0) {
+			pollfd pfd = {rx_fd, POLLIN, 0};
+			ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+			continue;
+		}
+
+		ASSERT_GE(hdlc_deframer_push(&deframer, buffer, len), 0);
+	}
+
+	EXPECT_EQ(record.frames, frames);
+	EXPECT_EQ(rx->stats.frames_in, 300u);
+	EXPECT_LT(rx->stats.recv_calls, 300u / 2);
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_bridge_udp_loopback, success)
+{
+	sockaddr_in addr[2] = {};
+	int fds[2];
+
+	for (int i = 0; i < 2; i++) {
+		fds[i] = socket(AF_INET, SOCK_DGRAM, 0);
+		ASSERT_GE(fds[i], 0);
+
+		const int size = 1 << 20;
+		setsockopt(fds[i], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+		socklen_t len = sizeof(addr[i]);
+		addr[i].sin_family = AF_INET;
+		addr[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		ASSERT_EQ(bind(fds[i], reinterpret_cast<sockaddr *>(&addr[i]), len), 0);
+		ASSERT_EQ(getsockname(fds[i], reinterpret_cast<sockaddr *>(&addr[i]), &len), 0);
+	}
+
+	for (int i = 0; i < 2; i++) {
+		const sockaddr *peer = reinterpret_cast<sockaddr *>(&addr[1 - i]);
+		ASSERT_EQ(connect(fds[i], peer, sizeof(addr[0])), 0);
+	}
+
+	bridgeFrames(fds[0], fds[1], HDLC_BRIDGE_UDP);
+
+	close(fds[0]);
+	close(fds[1]);
+}
+
+//--------------------------------------------------
+TEST(verify_bridge_tcp_loopback, success)
+{
+	sockaddr_in addr = {};
+	socklen_t len = sizeof(addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const int listener = socket(AF_INET, SOCK_STREAM, 0);
+	ASSERT_GE(listener, 0);
+	ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr *>(&addr), len), 0);
+	ASSERT_EQ(listen(listener, 1), 0);
+	ASSERT_EQ(getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len), 0);
+
+	const int client = socket(AF_INET, SOCK_STREAM, 0);
+	ASSERT_GE(client, 0);
+	ASSERT_EQ(connect(client, reinterpret_cast<sockaddr *>(&addr), len), 0);
+
+	const int server = accept(listener, nullptr, nullptr);
+	ASSERT_GE(server, 0);
+
+	bridgeFrames(client, server, HDLC_BRIDGE_TCP);
+
+	close(client);
+	close(server);
+	close(listener);
+}
+#endif
+
+#ifdef HDLC_TEST_IPC
+namespace
+{
+//--------------------------------------------------
+hdlc_frame_t createNumberedFrame(int i)
+{
+	hdlc_frame_t frame = createEmptyFrame();
+	frame.address = static_cast<uint8_t>(i);
+	frame.control.value = static_cast<uint8_t>(i >> 8);
+	frame.info_len = static_cast<hdlc_info_len_t>((i * 53) % (HDLC_INFO_MAX_LEN + 1));
+
+	for (int j = 0; j < frame.info_len; j++) {
+		frame.info[j] = static_cast<uint8_t>(i * 7 + j);
+	}
+
+	return frame;
+}
+
+//--------------------------------------------------
+void pushNumberedFrames(hdlc_ipc_t *ipc, int first, int count)
+{
+	std::vector<uint8_t> stream;
+	for (int i = first; i < first + count; i++) {
+		appendEncoded(stream, createNumberedFrame(i));
+	}
+
+	ASSERT_EQ(hdlc_ipc_push(ipc, stream.data(), stream.size()), count);
+}
+
+//--------------------------------------------------
+int consumeNumberedFrames(int fd, int ready, int count)
+{
+	hdlc_ipc_t ipc;
+	if (hdlc_ipc_attach(&ipc, fd) < 0) {
+		return 1;
+	}
+
+	if (write(ready, "", 1) != 1) {
+		return 2;
+	}
+
+	for (int i = 0; i < count;) {
+		const hdlc_ipc_frame_t *desc = hdlc_ipc_peek(&ipc);
+		if (desc == NULL) {
+			if (hdlc_ipc_wait(&ipc, 5000) != 1) {
+				return 3;
+			}
+			continue;
+		}
+
+		const bool match = desc->frame == createNumberedFrame(i);
+
+		if (hdlc_ipc_release(&ipc) < 0 || !match) {
+			return 4;
+		}
+
+		i++;
+	}
+
+	return ipc.lost == 0 ? 0 : 5;
+}
+} // namespace
+
+//--------------------------------------------------
+TEST(verify_ipc_broadcast_across_processes, success)
+{
+	hdlc_ipc_t ipc;
+	ASSERT_EQ(hdlc_ipc_create(&ipc, 512), 0);
+
+	int ready[2];
+	ASSERT_EQ(pipe(ready), 0);
+
+	// Two consumer processes that both see every frame
+	pid_t children[2];
+	for (pid_t &child : children) {
+		child = fork();
+		ASSERT_GE(child, 0);
+
+		if (child == 0) {
+			_exit(consumeNumberedFrames(dup(ipc.fd), ready[1], 300));
+		}
+	}
+
+	for (size_t i = 0; i < 2; i++) {
+		char byte;
+		ASSERT_EQ(read(ready[0], &byte, 1), 1);
+	}
+
+	for (int first = 0; first < 300; first += 25) {
+		pushNumberedFrames(&ipc, first, 25);
+	}
+
+	for (pid_t child : children) {
+		int status = 0;
+		ASSERT_EQ(waitpid(child, &status, 0), child);
+		EXPECT_TRUE(WIFEXITED(status));
+		EXPECT_EQ(WEXITSTATUS(status), 0);
+	}
+
+	close(ready[0]);
+	close(ready[1]);
+	EXPECT_EQ(hdlc_ipc_close(&ipc), 0);
+}
+
+//--------------------------------------------------
+TEST(verify_ipc_consumer_lapped, success)
+{
+	hdlc_ipc_t producer;
+	ASSERT_EQ(hdlc_ipc_create(&producer, 8), 0);
+
+	hdlc_ipc_t fast;
+	hdlc_ipc_t slow;
+	ASSERT_EQ(hdlc_ipc_attach(&fast, dup(producer.fd)), 0);
+	ASSERT_EQ(hdlc_ipc_attach(&slow, dup(producer.fd)), 0);
+	EXPECT_EQ(hdlc_ipc_wait(&fast, 0), 0);
+
+	pushNumberedFrames(&producer, 0, 3);
+	EXPECT_EQ(hdlc_ipc_wait(&fast, 0), 1);
+
+	for (int i = 0; i < 3; i++) {
+		const hdlc_ipc_frame_t *desc = hdlc_ipc_peek(&fast);
+		ASSERT_NE(desc, nullptr);
+		EXPECT_EQ(desc->frame, createNumberedFrame(i));
+		EXPECT_GT(desc->encoded_len, desc->frame.info_len + 4);
+		EXPECT_EQ(hdlc_ipc_release(&fast), 0);
+	}
+
+	EXPECT_EQ(hdlc_ipc_peek(&fast), nullptr);
+
+	// Nothing was handed out, so there is nothing to release
+	EXPECT_EQ(hdlc_ipc_release(&fast), -1);
+	EXPECT_EQ(fast.cursor, 3u);
+	EXPECT_EQ(fast.lost, 0u);
+
+	// Overwritten while held
+	pushNumberedFrames(&producer, 3, 1);
+	ASSERT_NE(hdlc_ipc_peek(&fast), nullptr);
+	pushNumberedFrames(&producer, 4, 7);
+	EXPECT_EQ(hdlc_ipc_release(&fast), -1);
+	EXPECT_EQ(fast.lost, 1u);
+
+	// Lapped, only the newest frames that are still in the ring are left
+	pushNumberedFrames(&producer, 11, 12);
+
+	std::vector<hdlc_frame_t> frames;
+	for (const hdlc_ipc_frame_t *desc; (desc = hdlc_ipc_peek(&slow)) != nullptr;) {
+		frames.push_back(desc->frame);
+		EXPECT_EQ(hdlc_ipc_release(&slow), 0);
+	}
+
+	EXPECT_EQ(slow.lost, 16u);
+	ASSERT_EQ(frames.size(), 7u);
+	for (int i = 0; i < 7; i++) {
+		EXPECT_EQ(frames[i], createNumberedFrame(16 + i));
+	}
+
+	EXPECT_EQ(hdlc_ipc_close(&slow), 0);
+	EXPECT_EQ(hdlc_ipc_close(&fast), 0);
+	EXPECT_EQ(hdlc_ipc_close(&producer), 0);
+
+	// An fd that does not hold a ring is closed when attaching to it fails
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	EXPECT_EQ(hdlc_ipc_attach(&slow, fds[0]), -1);
+	EXPECT_EQ(close(fds[0]), -1);
+	EXPECT_EQ(close(fds[1]), 0);
+}
+#endif
+
 //--------------------------------------------------
 int main()
 {